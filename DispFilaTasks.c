@@ -3,10 +3,23 @@
 #include "hardware/adc.h"
 #include "hardware/i2c.h"
 #include "lib/ssd1306.h"
+#include "lib/ui.h"
+#include "lib/tela.h"
 #include "lib/buzzer.h"
 #include "lib/led_matriz.h"
-#include "pio_matriz.pio.h"
-#include "lib/font.h"
+#include "lib/sensor_bus.h"
+#include "lib/aquisicao.h"
+#include "lib/alarme.h"
+#include "lib/canais.h"
+#include "lib/canais_estacao.h"
+#include "lib/filtro.h"
+#include "lib/previsao.h"
+#include "lib/latencia.h"
+#include "lib/instrumentacao.h"
+#include "lib/telemetria.h"
+#include "lib/historico.h"
+#include "lib/energia.h"
+#include "lib/config.h"
 #include "hardware/pwm.h"
 #include "FreeRTOS.h"
 #include "task.h"
@@ -19,8 +32,10 @@
 #define I2C_SDA 14
 #define I2C_SCL 15
 #define endereco 0x3C
-#define ADC_JOYSTICK_X 26
-#define ADC_JOYSTICK_Y 27
+#define ADC_PERIODO_MS 100      // Entre leituras publicadas (padrão, ajustável pela serial - config.h)
+#define ADC_DECIMACAO 1000      // Amostras por leitura publicada
+#define ADC_TAXA_HZ(periodo_ms) (ADC_DECIMACAO * 1000u / (periodo_ms))  // Amostras por segundo em cada canal
+#define ADC_TAXA_ECONOMIA_HZ 1000   // Em economia: uma leitura por segundo
 #define LED_RED 13
 #define LED_GREEN  11
 #define BUZZER 10
@@ -30,155 +45,252 @@
 ssd1306_t ssd;                  // Variável referente ao display
 bool cor = true;                // Variável booleana para habilitar a impressão no display
 
-typedef struct // Declaração de tipo para coleta dos dados do joystick
-{
-    uint16_t x_chuva;
-    uint16_t y_nivel;
-} joystick_data_t;
+_Static_assert(1 + 2 * CANAIS_MAX <= ENQ_MAX_DADOS, "amostra da telemetria não cabe em um registro");
+
+#if ESTACAO_BAIXO_CONSUMO
+// Volta à economia depois de 30 s sem motivo para vigiar; o display apaga depois de 1 min
+static const energia_config_t config_energia = { .calmaria_ms = 30000, .tela_ms = 60000 };
+#endif
 
-QueueHandle_t xQueueJoystickData;   // Criação da fila do FreeRTOS
+// Assinatura do barramento de amostras (display). Os atuadores são notificados
+// diretamente pelo avaliador de alarmes (alarme_subscribe)
+sensor_bus_sub_t *sub_display;
 
-// Função da tarefa para leitura do joystick
+// Função da tarefa de aquisição: lê o joystick, o sensor de temperatura e o
+// pluviômetro e publica os valores de todos os canais
 void vJoystickTask(void *params)
 {
-    adc_gpio_init(ADC_JOYSTICK_Y);
-    adc_gpio_init(ADC_JOYSTICK_X);
-    adc_init();
+    // Entradas do ADC da tabela em round-robin, média de 1000 amostras por leitura: no período padrão, 10 kHz cada
+    uint32_t taxa = ADC_TAXA_HZ(config_periodo_ms());
+    aquisicao_config_t cfg = { .canais = canais_mascara_adc(), .taxa_hz = taxa, .decimacao = ADC_DECIMACAO };
+    aquisicao_init(&cfg);
 
-    joystick_data_t joydata;  
+    aquisicao_bloco_t bloco;
+    sensor_amostra_t amostra;
+    alarme_nivel_t nivel_anterior = ALARME_NORMAL;     // A partida é normal: só uma mudança real gera registro
+    energia_modo_t modo = ENERGIA_VIGILANCIA;
+    uint8_t n = canais_num();
 
-    while (true) // Loop para leitura dos valores do ADC
+    while (true) // Uma ativação por bloco da DMA, não por amostra
     {
-        adc_select_input(0); // GPIO 26 = ADC0
-        joydata.y_nivel = adc_read();
+        if (aquisicao_aguardar(&bloco, portMAX_DELAY))
+        {
+            // Configuração ajustada pela serial: vale inteira a partir desta leitura
+            uint16_t periodo_ms;
+            if (config_aplicar(&periodo_ms)) {
+                taxa = ADC_TAXA_HZ(periodo_ms);
+                if (modo != ENERGIA_ECONOMIA)
+                    aquisicao_set_taxa(taxa);
+            }
+
+            int32_t lidos[CANAIS_MAX];
+            canais_ler(&bloco, lidos);                  // Brutos para décimos, todos os canais de uma vez
+            amostra.timestamp_us = bloco.timestamp_us;  // Fim do bloco, para medir a latência
+
+            // Mediana e média exponencial antes dos alarmes: picos isolados não cruzam os limiares
+            filtro_processar(lidos, amostra.valores, amostra.tendencias, n, amostra.timestamp_us);
+
+            // Avalia os alarmes antes de publicar: o display já recebe a amostra com o nível atualizado
+            alarme_nivel_t nivel = alarme_avaliar(amostra.valores, amostra.timestamp_us);
+
+            // Tendência de subida: o próximo nível é anunciado antes do limiar ser cruzado
+            previsao_t previsao = previsao_atualizar(amostra.valores, n, amostra.timestamp_us);
+            alarme_prever(previsao.nivel, previsao.segundos, amostra.timestamp_us);
+
+            sensor_bus_publish(&amostra);               // Publica a amostra para todos os consumidores
 
-        adc_select_input(1); // GPIO 27 = ADC1
-        joydata.x_chuva = adc_read();
+            // Perto de um limiar a aquisição volta na hora à taxa normal; em calmaria ela desacelera
+            bool vigiar = nivel >= ALARME_AVISO || previsao.nivel != ALARME_NORMAL || alarme_proximo(amostra.valores);
+            energia_modo_t novo = energia_atualizar(vigiar, amostra.timestamp_us);
+            if (novo != modo) {
+                aquisicao_set_taxa(novo == ENERGIA_ECONOMIA ? ADC_TAXA_ECONOMIA_HZ : taxa);
+                modo = novo;
+            }
+
+            // Telemetria binária: a tarefa escritora formata e envia depois
+            uint32_t t_us = (uint32_t)amostra.timestamp_us;
+            uint8_t registro[1 + 2 * CANAIS_MAX];
+            registro[0] = nivel;
+            for (uint8_t i = 0; i < n; i++) {
+                int32_t v = amostra.valores[i];
+                int16_t d = v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : (int16_t)v;
+                registro[1 + 2 * i] = (uint8_t)d;
+                registro[2 + 2 * i] = (uint8_t)((uint16_t)d >> 8);
+            }
+            telemetria_enviar(ENQ_AMOSTRA, t_us, registro, 1 + 2 * n);
 
-        xQueueSend(xQueueJoystickData, &joydata, 0); // Envia o valor do joystick para a fila
-        vTaskDelay(pdMS_TO_TICKS(100));              // 10 Hz de leitura
+            // Histórico na flash: só monta a página na RAM, quem grava é a vHistoricoTask
+            historico_amostra(amostra.timestamp_us, amostra.valores, n);
+            if (nivel != nivel_anterior) {
+                const uint8_t mudanca[] = { nivel, nivel_anterior };
+                telemetria_enviar(ENQ_ALARME, t_us, mudanca, sizeof(mudanca));
+                historico_alarme(amostra.timestamp_us, nivel, nivel_anterior);
+                historico_fechar_pagina();              // Mudanças de alarme vão logo para a flash
+                nivel_anterior = nivel;
+            }
+        }
     }
 }
 
-// Função da tarefa do display - Funções da matriz estão no arquivo ssd1306.c
+// Função da tarefa do display - a composição da tela está em tela.c e as funções do display em ssd1306.c
 void vDisplayTask(void *params)
 {
+    sensor_amostra_t amostra;
+    bool ligado = true;
+    tela_init(&ssd);
 
-    joystick_data_t joydata;
-    
     while (true)
     {
-        if (xQueueReceive(xQueueJoystickData, &joydata, portMAX_DELAY) == pdTRUE) // Verificação de presença de dados na fila
+        if (sensor_bus_receive(sub_display, &amostra, portMAX_DELAY)) // Verificação de presença de dados na fila
         {
-            uint16_t porcX = joydata.x_chuva * 100 / 4095 ;     // Variável para impressão da porcentagem do volume de chuva no display
-            uint16_t porcY = joydata.y_nivel * 100 / 4095 ;     // Variável para impressão da porcentagem do nível de água
-            char str_nivel[5];
-            char str_chuva[5];
-            
-            // Transformação das porcentagens em string
-            sprintf(str_chuva, "%d", porcX);
-            sprintf(str_nivel, "%d", porcY);
-            
-            if(joydata.x_chuva >= 3480 || joydata.y_nivel >= 3071){             // Verificação do limiar estipulado para níveis críticos
-                ssd1306_fill(&ssd, !cor);                                       // Limpa a tela
-                ssd1306_draw_string(&ssd, "ALERTA!", centralizar_texto("ALERTA!"), 5);                       // Mostra texto no display                          
-                ssd1306_draw_string(&ssd, "NIVEIS ANORMAIS", centralizar_texto("NIVEIS ANORMAIS"), 15);      // Mostra texto no display  
+            tela_atualizar(&amostra);
+
+            // Display apagado na economia: os widgets acumulam as mudanças até religar
+            if (energia_tela_ligada() != ligado)
+            {
+                ligado = !ligado;
+                ssd1306_power(&ssd, ligado);
             }
-            else{
-                ssd1306_fill(&ssd, !cor);                   // Limpa a tela
-                ssd1306_draw_string(&ssd, "Niveis normais", centralizar_texto("Niveis Normais"), 15); // Mostra texto no display
+
+            // Só os widgets alterados são rasterizados; sem mudanças nada vai ao I2C
+            if (ligado && tela_desenhar())
+            {
+                ssd1306_send_data_async(&ssd);                      // Envia só as páginas alteradas via DMA, sem bloquear
+                latencia_registrar(LATENCIA_DISPLAY, amostra.timestamp_us);
             }
-            ssd1306_draw_string(&ssd, "V. chuva:", 10, 35);         // Mostra texto Volume de chuva no display
-            ssd1306_draw_string(&ssd, str_chuva, 90, 35);           // Mostra porcentagem númerica 
-            ssd1306_draw_string(&ssd, "%", 110, 35);                // Mostra símbolo de porcentagem
-            ssd1306_draw_string(&ssd, "N. agua:", 10, 45);          // Mostra texto Nível de água no display
-            ssd1306_draw_string(&ssd, str_nivel, 90, 45);           // Mostra porcentagem númerica 
-            ssd1306_draw_string(&ssd, "%", 110, 45);                // Mostra símbolo de porcentagem
-            ssd1306_send_data(&ssd);                                // Envia dados para o display
         }
     }
 }
 
-// Função da tarefa do LED RGB
+// Função da tarefa do LED RGB - acende verde (normal), amarelo (aviso ou previsão) ou vermelho (alerta)
 void vLedTask(void *params)
 {
-    joystick_data_t joydata;
+    alarme_evento_t ev;
     while (true)
     {
-        if (xQueueReceive(xQueueJoystickData, &joydata, portMAX_DELAY) == pdTRUE)   // Verificação de presença de dados na fila
+        if (ulTaskNotifyTake(pdTRUE, portMAX_DELAY))              // Só acorda em mudanças de nível
         {
-            printf("leitura feita. Valor de X : %d\n", joydata.x_chuva);            // Imprime mensagem na comunicação serial para debug
-            printf("leitura feita. Valor de Y : %d\n", joydata.y_nivel);            // Imprime mensagem na comunicação serial para debug
-            if(joydata.x_chuva >= 3480 || joydata.y_nivel >= 3070){                 // Verificação do limiar estipulado para níveis críticos
-                gpio_put(LED_GREEN, false);
-                gpio_put(LED_RED, true);
-            }
-            else{
-                gpio_put(LED_GREEN, true);
-                gpio_put(LED_RED, false);
-
-            }
+            alarme_ultimo_evento(&ev);
+            gpio_put(LED_GREEN, ev.nivel <= ALARME_AVISO);
+            gpio_put(LED_RED, ev.nivel >= ALARME_AVISO || ev.previsto > ev.nivel);
+            latencia_registrar(LATENCIA_LED, ev.timestamp_us);
         }
-        vTaskDelay(pdMS_TO_TICKS(50)); // Atualiza a cada 50ms
     }
 }
 
-// Função da tarefa da matriz de LED's - Funções estão no arquivo led_matriz.c
+// Função da tarefa da matriz de LED's - animações e sequenciador no arquivo led_matriz.c
 void vMatrizTask(void *params){
-    // Declaração de variáveis utilizadas na matriz de LED's
-    joystick_data_t joydata;
-    PIO pio = pio0;
-    uint sm = 0;
-    uint offset = pio_add_program(pio, &pio_matriz_program);
-    pio_matriz_program_init(pio, sm, offset, pino_matriz);
+    alarme_evento_t ev;
 
     while(true){
-        if(xQueueReceive(xQueueJoystickData, &joydata, portMAX_DELAY) == pdTRUE){   // Verificação de presença de dados na fila
-            if(joydata.x_chuva >= 3480 || joydata.y_nivel >= 3071){                 // Verificação do limiar estipulado para níveis críticos
-                exclamacao();                   // Desenha exclamação na matriz de LED's
-                desenho_pio(0, pio, sm);        // Envia os dados para a matriz
-            }
-            else{
-                checkmark();                    // Desenha um checkmark na matriz de LED's
-                desenho_pio(0, pio, sm);        // Envia os dados para a matriz
-            }
+        if(ulTaskNotifyTake(pdTRUE, portMAX_DELAY)){               // Só acorda em mudanças de nível ou de previsão
+            alarme_ultimo_evento(&ev);
+            matriz_severidade(ev.nivel, ev.previsto);   // Animação de cada severidade; o temporizador troca os quadros
+            latencia_registrar(LATENCIA_MATRIZ, ev.timestamp_us);
         }
-        vTaskDelay(pdMS_TO_TICKS(50));          // Atualiza a cada 50ms
     }
 }
 
 // Função da tarefa do buzzer
 void vBuzzerTask(void *params){
-    joystick_data_t joydata;
+    alarme_evento_t ev;
+
+    while (true)
+    {
+        if (ulTaskNotifyTake(pdTRUE, portMAX_DELAY)){               // Só acorda em mudanças de nível ou de previsão
+            alarme_ultimo_evento(&ev);
+            if (ev.previsto > ev.nivel)
+                buzzer_tocar(&BUZZER_PREVISAO); // Limiar previsto: bipes distintos antes da sirene
+            else
+                buzzer_severidade(ev.nivel);    // Padrão sonoro de cada severidade - buzzer.c
+            latencia_registrar(LATENCIA_BUZZER, ev.timestamp_us);
+        }
+    }
+}
+
+// Imprime um registro do histórico em CSV, com os valores dos canais em unidades
+static void imprimir_historico(const historico_registro_t *r, void *ctx)
+{
+    if (r->tipo == HISTORICO_AMOSTRA)
+    {
+        printf("amostra,%u,%lu", r->boot, (unsigned long)r->t_ms);
+        for (uint8_t i = 0; i < r->num_valores; i++)
+        {
+            int32_t v = r->valores[i];
+            printf(",%s%ld.%ld", v < 0 ? "-" : "", (long)(v < 0 ? -v : v) / 10, (long)(v < 0 ? -v : v) % 10);
+        }
+        printf("\n");
+    }
+    else
+        printf("alarme,%u,%lu,%s,%s\n", r->boot, (unsigned long)r->t_ms,
+               alarme_nome_nivel(r->alarme), alarme_nome_nivel(r->anterior));
+}
 
+// Função da tarefa de instrumentação: acompanha o pico das filas e atende os
+// pedidos da serial (USB CDC): INSTR_COMANDO imprime o retrato em CSV,
+// HISTORICO_COMANDO despeja o histórico gravado na flash e as linhas que
+// começam com CONFIG_COMANDO leem e ajustam a configuração (config.c)
+void vInstrTask(void *params){
     while (true)
     {
-        if (xQueueReceive(xQueueJoystickData, &joydata, portMAX_DELAY) == pdTRUE){  // Verificação de presença de dados na fila
-            if(joydata.x_chuva >= 3480 || joydata.y_nivel >= 3070){                 // Verificação do limiar estipulado para níveis críticos
-                buzz(BUZZER, 600, 500);                                             // Função para acionar o buzzer - chama função no arquivo buzzer.c
-                    for(int i = 0; i < 10; i++)                                     // For loop para delay de 100 ms quebrado em pequenas intervalos
-                        vTaskDelay(pdMS_TO_TICKS(10));
+        vTaskDelay(pdMS_TO_TICKS(100));
+        instr_amostrar();
+        int c;
+        while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
+        {
+            if (config_caractere(c))
+                continue;                       // Parte de uma linha de comando
+            if (c == INSTR_COMANDO)
+                instr_retrato_csv();
+            else if (c == HISTORICO_COMANDO)
+            {
+                uint64_t inicio = time_us_64();
+                uint32_t n = historico_ler(imprimir_historico, NULL);
+                printf("# historico,%lu,%lu\n", (unsigned long)n, (unsigned long)(time_us_64() - inicio));
             }
         }
-        vTaskDelay(pdMS_TO_TICKS(50));          // Atualiza a cada 50ms
     }
 }
 
+// Função da tarefa gravadora do histórico: as pausas de apagar/programar a
+// flash ficam nela, fora do caminho das amostras
+void vHistoricoTask(void *params){
+    while (true)
+    {
+        historico_gravar(portMAX_DELAY);
+    }
+}
+
+// Função da tarefa escritora da telemetria: esvazia a fila e envia os quadros binários
+void vTelemetriaTask(void *params){
+    while (true)
+    {
+        telemetria_escrever(portMAX_DELAY);
+    }
+}
+
+#ifdef ESTACAO_BENCH_LATENCIA
+// Tarefa do modo benchmark: imprime os percentis de latência a cada 10 s
+void vBenchTask(void *params){
+    while (true)
+    {
+        vTaskDelay(pdMS_TO_TICKS(10000));
+        latencia_relatorio();
+    }
+}
+#endif
+
 // Modo BOOTSEL com botão B - Limpa Display & Matriz
 void gpio_irq_handler(uint gpio, uint32_t events)
 {   
-    PIO pio = pio0;
-    uint sm = 0;
-    uint offset = pio_add_program(pio, &pio_matriz_program);
-    pio_matriz_program_init(pio, sm, offset, pino_matriz);
-
     // Limpa Display
     ssd1306_fill(&ssd, !cor);
     ssd1306_send_data(&ssd);
 
-    // Limpa matriz de LED's
+    // Limpa matriz de LED's (o quadro de trás substitui o da animação)
     limpar_todos_leds();
-    desenho_pio(0, pio, sm);
+    matriz_apresentar();
+    matriz_aguardar();
 
     // Põe em modo bootsel
     reset_usb_boot(0, 0);
@@ -201,11 +313,13 @@ void setup(){
     gpio_pull_up(botaoB);
     gpio_set_irq_enabled_with_callback(botaoB, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
 
-    // Inicializa o buzzer
-    gpio_init(BUZZER);
-    gpio_set_dir(BUZZER,GPIO_OUT);
+    // Inicializa o buzzer (PWM e sequenciador de padrões)
+    buzzer_init(BUZZER);
     
 
+    // Inicializa a matriz de LED's (programa PIO e canal de DMA)
+    matriz_init(pio0, pino_matriz);
+
     // Inicializa o I2C do display
     i2c_init(I2C_PORT, 400 * 1000);
     gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
@@ -219,21 +333,105 @@ void setup(){
 
 }
 
+// Pilhas e TCBs de todas as tarefas, alocados estaticamente: o firmware não tem
+// heap do FreeRTOS, e cada pilha aparece pelo nome no relatório de memória
+static StackType_t pilha_joystick[256], pilha_buzzer[256], pilha_display[512], pilha_led[256],
+                   pilha_matriz[256], pilha_instr[512], pilha_historico[256], pilha_telemetria[256];
+static StaticTask_t tcb_joystick, tcb_buzzer, tcb_display, tcb_led,
+                    tcb_matriz, tcb_instr, tcb_historico, tcb_telemetria;
+#ifdef ESTACAO_BENCH_LATENCIA
+static StackType_t pilha_bench[512];
+static StaticTask_t tcb_bench;
+#endif
+
+// Pilhas das tarefas do kernel (ociosas e temporizadores)
+static StackType_t pilha_ociosa[ESTACAO_NUM_CORES][configMINIMAL_STACK_SIZE];
+static StaticTask_t tcb_ociosa[ESTACAO_NUM_CORES];
+static StackType_t pilha_timers[configTIMER_TASK_STACK_DEPTH];
+static StaticTask_t tcb_timers;
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **pilha, configSTACK_DEPTH_TYPE *tamanho)
+{
+    *tcb = &tcb_ociosa[0];
+    *pilha = pilha_ociosa[0];
+    *tamanho = configMINIMAL_STACK_SIZE;
+}
+
+#if ESTACAO_NUM_CORES > 1
+void vApplicationGetPassiveIdleTaskMemory(StaticTask_t **tcb, StackType_t **pilha, configSTACK_DEPTH_TYPE *tamanho, BaseType_t indice)
+{
+    *tcb = &tcb_ociosa[1 + indice];
+    *pilha = pilha_ociosa[1 + indice];
+    *tamanho = configMINIMAL_STACK_SIZE;
+}
+#endif
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **tcb, StackType_t **pilha, configSTACK_DEPTH_TYPE *tamanho)
+{
+    *tcb = &tcb_timers;
+    *pilha = pilha_timers;
+    *tamanho = configTIMER_TASK_STACK_DEPTH;
+}
+
+// Cria uma tarefa fixada no núcleo indicado (a afinidade não tem efeito no build de um núcleo)
+static TaskHandle_t criar_tarefa(TaskFunction_t funcao, const char *nome, StackType_t *pilha, configSTACK_DEPTH_TYPE palavras,
+                                 StaticTask_t *tcb, UBaseType_t prioridade, UBaseType_t nucleo)
+{
+    TaskHandle_t tarefa = xTaskCreateStatic(funcao, nome, palavras, NULL, prioridade, pilha, tcb);
+    if (tarefa == NULL)
+        return NULL;
+#if ESTACAO_NUM_CORES > 1
+    vTaskCoreAffinitySet(tarefa, 1u << nucleo);
+#else
+    (void)nucleo;
+#endif
+    return tarefa;
+}
+#define CRIAR_TAREFA(funcao, nome, id, prioridade, nucleo) \
+    criar_tarefa(funcao, nome, pilha_##id, count_of(pilha_##id), &tcb_##id, prioridade, nucleo)
+
 int main()
 {   
 
     setup();            // Chama função para setup inicial dos periféricos
     stdio_init_all();
 
-    // Cria a fila para compartilhamento de valor do joystick
-    xQueueJoystickData = xQueueCreate(30, sizeof(joystick_data_t));
+    // O display recebe todas as amostras; LED, matriz e buzzer
+    // dependem apenas do nível de alarme e recebem somente os eventos de mudança
+    sub_display = sensor_bus_subscribe(SENSOR_BUS_RING, 8);   // Anel sem travas: produtor e display ficam em núcleos diferentes
+    canais_init(canais_estacao, canais_estacao_num);        // Entradas dos canais e limiares dos alarmes (canais_estacao.c)
+    config_init(ADC_PERIODO_MS);                            // Limiares, filtros e período ajustados em campo e gravados na flash
+#if ESTACAO_BAIXO_CONSUMO
+    energia_init(&config_energia);
+#else
+    energia_init(NULL);                                     // Sempre na taxa normal; só mede o sono dos núcleos
+#endif
+    telemetria_init();
+    historico_init();
+    historico_stats_t h = historico_stats();
+    printf("historico: boot %u, %lu paginas validas, varredura em %lu us\n",
+           h.boot, (unsigned long)h.paginas_validas, (unsigned long)h.varredura_us);
+    instr_registrar_anel("display", &sub_display->anel);
+
+    // Criação das tasks: aquisição, alarmes e buzzer no núcleo 0; display, matriz e
+    // serial (telemetria e retratos da instrumentação) no núcleo 1
+    CRIAR_TAREFA(vJoystickTask, "Joystick Task", joystick, 1, 0);
+    TaskHandle_t buzzer = CRIAR_TAREFA(vBuzzerTask, "Buzzer Task", buzzer, 1, 0);
+    CRIAR_TAREFA(vDisplayTask, "Display Task", display, 1, 1);
+    TaskHandle_t led = CRIAR_TAREFA(vLedTask, "LED red Task", led, 1, 1);
+    TaskHandle_t matriz = CRIAR_TAREFA(vMatrizTask, "Matriz Task", matriz, 1, 1);
+    CRIAR_TAREFA(vInstrTask, "Instr Task", instr, 1, 1);
+    CRIAR_TAREFA(vHistoricoTask, "Historico Task", historico, 1, 1);
+    CRIAR_TAREFA(vTelemetriaTask, "Telemetria Task", telemetria, tskIDLE_PRIORITY, 1);   // Só escreve quando o resto está ocioso
+#ifdef ESTACAO_BENCH_LATENCIA
+    CRIAR_TAREFA(vBenchTask, "Bench Task", bench, 1, 1);
+#endif
+
+    // Os atuadores só acordam com as mudanças de nível, por notificação direta
+    alarme_subscribe(led);
+    alarme_subscribe(matriz);
+    alarme_subscribe(buzzer);
 
-    // Criação das tasks
-    xTaskCreate(vJoystickTask, "Joystick Task", 256, NULL, 1, NULL);
-    xTaskCreate(vDisplayTask, "Display Task", 512, NULL, 1, NULL);
-    xTaskCreate(vLedTask, "LED red Task", 256, NULL, 1, NULL);
-    xTaskCreate(vMatrizTask, "Matriz Task", 256, NULL, 1, NULL);
-    xTaskCreate(vBuzzerTask, "Buzzer Task", 256, NULL, 1, NULL);
     // Inicia o agendador
     vTaskStartScheduler();
     panic_unsupported();
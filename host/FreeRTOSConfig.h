@@ -0,0 +1,59 @@
+/*
+ * Configuração do FreeRTOS para a simulação nativa (porta POSIX).
+ *
+ * Reaproveita lib/FreeRTOSConfig.h e sobrescreve apenas o que é específico do
+ * RP2040, além de ligar os ganchos de trace usados para medir escalonamento e
+ * ocupação das filas.
+ */
+
+#ifndef HOST_FREERTOS_CONFIG_H
+#define HOST_FREERTOS_CONFIG_H
+
+#include "../lib/FreeRTOSConfig.h"
+
+/* A simulação roda sempre em um único núcleo */
+#undef ESTACAO_NUM_CORES
+#define ESTACAO_NUM_CORES                       1
+#undef configNUM_CORES
+#undef configTICK_CORE
+#undef configRUN_MULTIPLE_PRIORITIES
+#undef configUSE_CORE_AFFINITY
+#undef configSUPPORT_PICO_SYNC_INTEROP
+#undef configSUPPORT_PICO_TIME_INTEROP
+#define configNUMBER_OF_CORES                   1
+
+/* A porta POSIX não suspende o tick e não há WFI: sem ganchos de sono */
+#undef configUSE_TICKLESS_IDLE
+#define configUSE_TICKLESS_IDLE                 0
+#undef configUSE_IDLE_HOOK
+#define configUSE_IDLE_HOOK                     0
+#undef configUSE_PASSIVE_IDLE_HOOK
+#define configUSE_PASSIVE_IDLE_HOOK             0
+
+/* A tarefa que faz o papel das interrupções (hal_irq.c) é criada dinamicamente */
+#undef configSUPPORT_DYNAMIC_ALLOCATION
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#undef configTOTAL_HEAP_SIZE
+#define configTOTAL_HEAP_SIZE                   (64*1024)
+
+/* A porta POSIX fornece o próprio contador das estatísticas de execução */
+#undef portCONFIGURE_TIMER_FOR_RUN_TIME_STATS
+#undef portGET_RUN_TIME_COUNTER_VALUE
+
+/* Cada tarefa é uma pthread: a pilha do FreeRTOS não é a pilha real da thread */
+#undef configSTACK_DEPTH_TYPE
+#define configSTACK_DEPTH_TYPE                  size_t
+
+/* Ganchos de trace (definidos em host/hal_sim.c). São chamados dentro do
+   escalonador, inclusive a partir do tratador de sinal do tick, por isso só
+   gravam em um buffer em memória */
+#ifndef __ASSEMBLER__
+void host_trace_task_switched_in(void *tcb);
+void host_trace_queue(void *fila, unsigned long ocupacao);
+#endif
+#undef traceTASK_SWITCHED_IN
+#define traceTASK_SWITCHED_IN()     host_trace_task_switched_in( ( void * ) pxCurrentTCB )
+/* Ocupação da fila antes da cópia do item */
+#define traceQUEUE_SEND( pxQueue )  host_trace_queue( ( void * ) ( pxQueue ), ( pxQueue )->uxMessagesWaiting )
+
+#endif /* HOST_FREERTOS_CONFIG_H */
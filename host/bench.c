@@ -0,0 +1,478 @@
+// Benchmark da cadeia de alerta na simulação nativa
+//
+// Reproduz um trace gravado ou sintético pela mesma cadeia da tarefa da
+// aquisição e dos consumidores, com as fontes do firmware: conversão dos
+// canais, filtro, alarmes, previsão, composição da tela, rasterização, envio
+// ao display (modelo do SSD1306 em hal_i2c.c) e desenho da matriz (PIO
+// simulada). Tudo roda em main(), sem tarefas nem agendador: o tempo das
+// amostras vem do trace, e a sequência de saídas (resumida em um hash) só
+// depende dele.
+//
+// Uso: estacao_bench [-n amostras] [-s semente] [trace.csv]
+//
+// O trace tem o formato de ESTACAO_ADC_CSV ("t_ms,adc0,adc1,adc2,adc3,adc4"),
+// com uma sétima coluna opcional: pulsos do pluviômetro na janela de 1 min.
+// Sem arquivo, gera 'amostras' leituras a 10 Hz (padrão: 2 milhões, ~55 h)
+// com ondas lentas, ruído, picos e chuvas intermitentes.
+//
+// Saída em CSV:
+//   etapa,<nome>,<chamadas>,<ns_por_chamada>,<ns_por_amostra>,<alocacoes>
+//   total,<amostras>,<amostras_por_s>,<alocacoes>
+//   saida,<mudancas_alarme>,<previsoes>,<envios_display>,<bytes_display>,<quadros_matriz>,<hash>
+//   comparacao,<nome>,<repeticoes>,<ns_referencia>,<ns_atual>
+// Os tempos já descontam o custo da própria medição. As alocações contam
+// malloc/calloc/realloc feitos pelas fontes durante o laço: nenhum módulo usa
+// heap, então qualquer valor diferente de zero é uma regressão.
+//
+// As comparações medem uma rotina atual contra a versão anterior, mantida
+// aqui como referência. 'texto' desenha as linhas de uma tela de alerta pixel
+// a pixel (como o ssd1306_draw_char original) e por bytes de página; se os
+// quadros diferirem o benchmark também sai com código 1. 'grb' codifica um
+// quadro da matriz a partir de cores em double (o Pixel original) e a partir
+// de cores de 8 bits pela tabela de gama e brilho (matrix_rgb atual).
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "canais_estacao.h"
+#include "filtro.h"
+#include "previsao.h"
+#include "alarme.h"
+#include "tela.h"
+#include "ssd1306.h"
+#include "led_matriz.h"
+#include "hal_host.h"
+#include "font.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_AMOSTRAS_PADRAO 2000000u
+#define BENCH_PERIODO_MS 100            // Leituras sintéticas a 10 Hz, como a aquisição
+#define BENCH_CALIBRACAO 1000000        // Pares de medições vazias para estimar o custo de medir
+#define BENCH_REPETICOES 20000          // Repetições de cada comparação
+#define BENCH_REPETICOES_GRB 1000000    // Um quadro da matriz leva dezenas de ns: mais repetições
+
+// Sem limite de duração: o benchmark termina ao fim do trace (hal_sim.c)
+const uint32_t host_duracao_padrao_ms = 0;
+
+typedef struct {
+    uint32_t t_ms;
+    uint16_t adc[5];
+    uint16_t pulsos;
+} linha_t;
+
+typedef enum {
+    ETAPA_CONVERSAO,
+    ETAPA_FILTRO,
+    ETAPA_ALARME,
+    ETAPA_PREVISAO,
+    ETAPA_TELA,
+    ETAPA_DESENHO,
+    ETAPA_ENVIO,
+    ETAPA_MATRIZ,
+    NUM_ETAPAS
+} etapa_t;
+
+static const char *const nomes_etapas[NUM_ETAPAS] = {
+    "conversao", "filtro", "alarme", "previsao", "tela", "desenho", "envio", "matriz",
+};
+
+typedef struct {
+    uint64_t chamadas;
+    uint64_t ns;
+    uint64_t alocacoes;
+} medida_t;
+
+static medida_t medidas[NUM_ETAPAS];
+static uint64_t custo_medicao_ns;
+
+// ------------------------------------------------------------------ Alocações
+
+// As chamadas das fontes passam por aqui com -Wl,--wrap (host_sim.cmake)
+static volatile bool contando = false;
+static volatile uint64_t alocacoes = 0;
+
+void *__real_malloc(size_t n);
+void *__real_calloc(size_t n, size_t tam);
+void *__real_realloc(void *p, size_t n);
+
+void *__wrap_malloc(size_t n) {
+    if (contando)
+        alocacoes++;
+    return __real_malloc(n);
+}
+
+void *__wrap_calloc(size_t n, size_t tam) {
+    if (contando)
+        alocacoes++;
+    return __real_calloc(n, tam);
+}
+
+void *__wrap_realloc(void *p, size_t n) {
+    if (contando)
+        alocacoes++;
+    return __real_realloc(p, n);
+}
+
+// ------------------------------------------------------------------ Medição
+
+static inline uint64_t agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+typedef struct {
+    uint64_t t0;
+    uint64_t alocacoes;
+} marca_t;
+
+static inline marca_t iniciar(void) {
+    return (marca_t){ agora_ns(), alocacoes };
+}
+
+static inline void encerrar(etapa_t e, marca_t m) {
+    uint64_t t1 = agora_ns();
+    medidas[e].chamadas++;
+    medidas[e].ns += t1 - m.t0;
+    medidas[e].alocacoes += alocacoes - m.alocacoes;
+}
+
+static void calibrar(void) {
+    uint64_t inicio = agora_ns();
+    for (int i = 0; i < BENCH_CALIBRACAO; i++) {
+        volatile uint64_t a = agora_ns();
+        volatile uint64_t b = agora_ns();
+        (void)a;
+        (void)b;
+    }
+    custo_medicao_ns = (agora_ns() - inicio) / BENCH_CALIBRACAO / 2;
+}
+
+// FNV-1a das saídas, para comparar execuções e versões das bibliotecas
+static uint64_t hash = 0xcbf29ce484222325ull;
+
+static void misturar(const void *dados, size_t n) {
+    const uint8_t *p = dados;
+    for (size_t i = 0; i < n; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ull;
+    }
+}
+
+// ------------------------------------------------------------------ Traces
+
+static linha_t *carregar_csv(const char *caminho, uint32_t *n) {
+    FILE *f = fopen(caminho, "r");
+    if (!f) {
+        perror(caminho);
+        exit(1);
+    }
+    uint32_t capacidade = 1 << 16;
+    linha_t *linhas = malloc(capacidade * sizeof(linha_t));
+    char buf[256];
+    *n = 0;
+    while (fgets(buf, sizeof(buf), f)) {
+        if (!isdigit((unsigned char)buf[0]))
+            continue;
+        unsigned t, a[5] = {0}, p = 0;
+        if (sscanf(buf, "%u,%u,%u,%u,%u,%u,%u", &t, &a[0], &a[1], &a[2], &a[3], &a[4], &p) < 3)
+            continue;
+        if (*n == capacidade) {
+            capacidade *= 2;
+            linhas = realloc(linhas, capacidade * sizeof(linha_t));
+        }
+        linha_t *l = &linhas[(*n)++];
+        l->t_ms = t;
+        for (int k = 0; k < 5; k++)
+            l->adc[k] = (uint16_t)(a[k] > 4095 ? 4095 : a[k]);
+        l->pulsos = (uint16_t)p;
+    }
+    fclose(f);
+    return linhas;
+}
+
+static uint32_t aleatorio_estado;
+
+static uint32_t aleatorio(void) {
+    uint32_t x = aleatorio_estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return aleatorio_estado = x;
+}
+
+static int32_t ruido(int32_t amplitude) {
+    return (int32_t)(aleatorio() % (2 * amplitude + 1)) - amplitude;
+}
+
+static uint16_t limitar(int32_t v) {
+    return (uint16_t)(v < 0 ? 0 : v > 4095 ? 4095 : v);
+}
+
+// Nível em triângulo de 20 min entre 40% e 95%; chuva em rajadas de alguns
+// minutos; picos isolados de 1 a 3 leituras em 1% das leituras
+static linha_t *gerar(uint32_t n, uint32_t semente) {
+    linha_t *linhas = malloc(n * sizeof(linha_t));
+    aleatorio_estado = semente ? semente : 1;
+    int32_t chuva = 800, pico = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        linha_t *l = &linhas[i];
+        l->t_ms = i * BENCH_PERIODO_MS;
+        uint32_t fase = l->t_ms % 1200000;
+        int32_t nivel = 1640 + (int32_t)((fase < 600000 ? fase : 1200000 - fase) * 2250 / 600000);
+        if ((l->t_ms / 60000) % 7 < 2)
+            chuva += (3900 - chuva) / 300;          // Rajada
+        else
+            chuva += (800 - chuva) / 600;
+        if (pico == 0 && aleatorio() % 100 == 0)
+            pico = 1 + aleatorio() % 3;
+        if (pico) {
+            nivel += 800;
+            pico--;
+        }
+        l->adc[0] = limitar(nivel + ruido(30));
+        l->adc[1] = limitar(chuva + ruido(30));
+        l->adc[2] = l->adc[3] = 0;
+        l->adc[4] = limitar(876 + ruido(3));
+        l->pulsos = (uint16_t)((chuva - 800) / 400);
+    }
+    return linhas;
+}
+
+// ------------------------------------------------------------------ Versões anteriores
+
+// ssd1306_draw_char original: um ssd1306_pixel por pixel do glifo 8x8
+static void texto_por_pixel(ssd1306_t *d, const char *str, uint8_t x, uint8_t y) {
+    for (; *str; str++, x += 8) {
+        uint8_t indice = (uint8_t)*str;
+        if (indice == 135)
+            indice = 127;
+        else if (indice >= 129)
+            indice = 0;
+        for (uint8_t i = 0; i < 8; i++) {
+            uint8_t linha = font[indice][i];
+            for (uint8_t j = 0; j < 8; j++, linha >>= 1)
+                ssd1306_pixel(d, x + j, y + i, linha & 0x01);
+        }
+    }
+}
+
+// Linhas de uma tela de alerta, incluindo posições fora do limite das páginas
+static const struct { const char *texto; uint8_t x, y; } linhas_alerta[] = {
+    { "ALERTA  NIVEL", 12, 0 },
+    { "nivel  87.5 %", 0, 19 },
+    { "chuva  42.0 %", 0, 29 },
+    { "temp   24.1 C", 4, 40 },
+    { "pluv   12 mm/h", 4, 48 },
+    { "crit em 95 s", 16, 56 },
+};
+
+static ssd1306_t ssd_referencia, ssd_atual;
+
+static uint64_t desenhar_alerta(ssd1306_t *d, bool por_pixel) {
+    uint64_t t0 = agora_ns();
+    for (int r = 0; r < BENCH_REPETICOES; r++) {
+        ssd1306_fill(d, r & 1);
+        for (size_t i = 0; i < count_of(linhas_alerta); i++) {
+            if (por_pixel)
+                texto_por_pixel(d, linhas_alerta[i].texto, linhas_alerta[i].x, linhas_alerta[i].y);
+            else
+                ssd1306_draw_string(d, linhas_alerta[i].texto, linhas_alerta[i].x, linhas_alerta[i].y);
+        }
+    }
+    return (agora_ns() - t0) / BENCH_REPETICOES;
+}
+
+// Retorna false se os quadros das duas versões diferirem
+static bool comparar_texto(void) {
+    ssd1306_init(&ssd_referencia, WIDTH, HEIGHT, false, 0x3C, i2c0);
+    ssd1306_init(&ssd_atual, WIDTH, HEIGHT, false, 0x3C, i2c0);
+    uint64_t referencia = desenhar_alerta(&ssd_referencia, true);
+    uint64_t atual = desenhar_alerta(&ssd_atual, false);
+    printf("comparacao,texto,%u,%llu,%llu\n", BENCH_REPETICOES, (unsigned long long)referencia,
+           (unsigned long long)atual);
+    return memcmp(ssd_referencia.ram_buffer, ssd_atual.ram_buffer, ssd_atual.bufsize) == 0;
+}
+
+// Pixel e matrix_rgb originais: três double por LED, convertidos a cada envio
+typedef struct { double r, g, b; } pixel_double_t;
+
+static uint32_t grb_double(double b, double r, double g) {
+    return ((uint32_t)(g * 255) << 24) | ((uint32_t)(r * 255) << 16) | (uint32_t)(b * 255) << 8;
+}
+
+static volatile uint32_t grb_saida;     // Mantém o resultado vivo sem uma escrita por LED
+
+static void comparar_grb(void) {
+    // Padrão com LEDs em três cores, trocado a cada repetição para não ser constante
+    pixel_double_t quadro_double[2][NUM_PIXELS];
+    uint8_t quadro_8[2][NUM_PIXELS][3];
+    for (int q = 0; q < 2; q++) {
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            uint8_t c = (uint8_t)((i + q) % 3 == 0 ? 255 : (i + q) % 3 == 1 ? 128 : 0);
+            quadro_double[q][i] = (pixel_double_t){ c * 0.1 / 255, (255 - c) * 0.1 / 255, 0.05 };
+            quadro_8[q][i][0] = c;
+            quadro_8[q][i][1] = 255 - c;
+            quadro_8[q][i][2] = 128;
+        }
+    }
+
+    uint32_t soma = 0;
+    uint64_t t0 = agora_ns();
+    for (int r = 0; r < BENCH_REPETICOES_GRB; r++) {
+        const pixel_double_t *d = quadro_double[r & 1];
+        for (int i = 0; i < NUM_PIXELS; i++)
+            soma += grb_double(d[NUM_PIXELS - 1 - i].b, d[NUM_PIXELS - 1 - i].r, d[NUM_PIXELS - 1 - i].g) ^ (uint32_t)i;
+    }
+    uint64_t referencia = (agora_ns() - t0) / BENCH_REPETICOES_GRB;
+
+    t0 = agora_ns();
+    for (int r = 0; r < BENCH_REPETICOES_GRB; r++) {
+        uint8_t (*c)[3] = quadro_8[r & 1];
+        for (int i = 0; i < NUM_PIXELS; i++)
+            soma += matrix_rgb(c[i][0], c[i][1], c[i][2]) ^ (uint32_t)i;
+    }
+    uint64_t atual = (agora_ns() - t0) / BENCH_REPETICOES_GRB;
+    grb_saida = soma;
+
+    printf("comparacao,grb,%u,%llu,%llu\n", BENCH_REPETICOES_GRB, (unsigned long long)referencia,
+           (unsigned long long)atual);
+}
+
+// ------------------------------------------------------------------ Cadeia
+
+static ssd1306_t ssd;
+
+int main(int argc, char **argv) {
+    uint32_t n = BENCH_AMOSTRAS_PADRAO, semente = 1;
+    const char *caminho = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            n = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            semente = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (argv[i][0] != '-')
+            caminho = argv[i];
+        else {
+            fprintf(stderr, "uso: %s [-n amostras] [-s semente] [trace.csv]\n", argv[0]);
+            return 2;
+        }
+    }
+    linha_t *linhas = caminho ? carregar_csv(caminho, &n) : gerar(n, semente);
+    if (n == 0) {
+        fprintf(stderr, "%s: trace vazio\n", caminho);
+        return 1;
+    }
+
+    // Mesma inicialização do firmware, sem criar tarefas
+    canais_init(canais_estacao, canais_estacao_num);
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c1);
+    ssd1306_config(&ssd);
+    matriz_init(pio0, pino_matriz);
+    tela_init(&ssd);
+    calibrar();
+
+    uint8_t num = canais_num();
+    sensor_amostra_t amostra = {0};
+    uint32_t brutos[CANAIS_MAX];
+    int32_t lidos[CANAIS_MAX];
+    alarme_nivel_t nivel_saidas = ALARME_NUM_NIVEIS, previsto_saidas = ALARME_NUM_NIVEIS;
+    uint32_t envios = 0, quadros_matriz = 0;
+
+    contando = true;
+    uint64_t inicio = agora_ns();
+    for (uint32_t k = 0; k < n; k++) {
+        const linha_t *l = &linhas[k];
+        for (uint8_t i = 0; i < num; i++) {
+            const canal_t *c = canais_canal(i);
+            brutos[i] = c->fonte == CANAL_ADC ? l->adc[c->entrada] : l->pulsos;
+        }
+        amostra.timestamp_us = (uint64_t)l->t_ms * 1000u;
+        amostra.seq = k;
+
+        marca_t m = iniciar();
+        canais_converter(brutos, lidos);
+        encerrar(ETAPA_CONVERSAO, m);
+
+        m = iniciar();
+        filtro_processar(lidos, amostra.valores, amostra.tendencias, num, amostra.timestamp_us);
+        encerrar(ETAPA_FILTRO, m);
+
+        m = iniciar();
+        alarme_nivel_t nivel = alarme_avaliar(amostra.valores, amostra.timestamp_us);
+        encerrar(ETAPA_ALARME, m);
+
+        m = iniciar();
+        previsao_t p = previsao_atualizar(amostra.valores, num, amostra.timestamp_us);
+        alarme_prever(p.nivel, p.segundos, amostra.timestamp_us);
+        encerrar(ETAPA_PREVISAO, m);
+
+        // Display: todas as amostras, como a tarefa do display
+        m = iniciar();
+        tela_atualizar(&amostra);
+        encerrar(ETAPA_TELA, m);
+
+        m = iniciar();
+        bool desenhou = tela_desenhar();
+        encerrar(ETAPA_DESENHO, m);
+
+        if (desenhou) {
+            m = iniciar();
+            ssd1306_send_data_async(&ssd);
+            ssd1306_wait(&ssd);
+            encerrar(ETAPA_ENVIO, m);
+            envios++;
+            misturar(ssd.ram_buffer, sizeof(ssd.ram_buffer));
+        }
+
+        // Matriz: só nos eventos do avaliador (mudança de nível ou de previsão)
+        alarme_nivel_t previsto = alarme_previsao(NULL);
+        if (nivel != nivel_saidas || previsto != previsto_saidas) {
+            nivel_saidas = nivel;
+            previsto_saidas = previsto;
+            // Um ciclo da animação escolhida, com o sequenciador chamado no lugar do temporizador
+            m = iniciar();
+            const matriz_anim_t *anim = matriz_severidade(nivel, previsto);
+            for (uint8_t q = 0; q < anim->num_quadros; q++) {
+                matriz_sequenciar();
+                matriz_aguardar();
+            }
+            encerrar(ETAPA_MATRIZ, m);
+            quadros_matriz += anim->num_quadros;
+            uint8_t ev[2] = { nivel, previsto };
+            misturar(ev, sizeof(ev));
+            misturar(anim->codificados, anim->num_quadros * sizeof(anim->codificados[0]));
+        }
+    }
+    uint64_t total_ns = agora_ns() - inicio;
+    contando = false;
+
+    // O tempo total também inclui a montagem das leituras e o hash
+    uint64_t total_alocacoes = 0;
+    for (int e = 0; e < NUM_ETAPAS; e++) {
+        const medida_t *d = &medidas[e];
+        uint64_t ns = d->ns > d->chamadas * custo_medicao_ns ? d->ns - d->chamadas * custo_medicao_ns : 0;
+        printf("etapa,%s,%llu,%llu,%llu,%llu\n", nomes_etapas[e], (unsigned long long)d->chamadas,
+               (unsigned long long)(d->chamadas ? ns / d->chamadas : 0), (unsigned long long)(ns / n),
+               (unsigned long long)d->alocacoes);
+        total_alocacoes += d->alocacoes;
+    }
+    printf("total,%lu,%llu,%llu\n", (unsigned long)n,
+           (unsigned long long)(total_ns ? (uint64_t)n * 1000000000u / total_ns : 0),
+           (unsigned long long)total_alocacoes);
+    previsao_stats_t ps = previsao_stats();
+    printf("saida,%lu,%lu,%lu,%lu,%lu,%016llx\n", (unsigned long)alarme_mudancas(), (unsigned long)ps.emitidas,
+           (unsigned long)envios, (unsigned long)ssd.bytes_sent, (unsigned long)quadros_matriz,
+           (unsigned long long)hash);
+    free(linhas);
+
+    bool quadros_iguais = comparar_texto();
+    if (!quadros_iguais)
+        fprintf(stderr, "comparacao,texto: quadros diferentes da referencia\n");
+    comparar_grb();
+    return total_alocacoes || !quadros_iguais ? 1 : 0;
+}
@@ -0,0 +1,205 @@
+// ADC simulado: reprodução de um CSV ou sinal sintético
+//
+// ESTACAO_ADC_CSV aponta para um arquivo com linhas "t_ms,adc0,adc1[,adc2,adc3,adc4]",
+// ordenadas pelo tempo. Linhas que não começam com número (cabeçalho, '#') são
+// ignoradas. Cada leitura devolve o valor da última linha com t_ms <= tempo atual;
+// depois do fim do arquivo o último valor é mantido.
+//
+// Sem CSV, os canais 0 (nível) e 1 (chuva) seguem ondas triangulares lentas com
+// um pouco de ruído, cruzando os limiares de alerta periodicamente.
+//
+// No modo contínuo (adc_run) as conversões são geradas no instante em que
+// ocorreriam, pelo divisor configurado, e entregues à DMA com DREQ_ADC.
+
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "pico/time.h"
+#include "hal_host.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ADC_CANAIS 5
+#define ADC_CICLOS_CONVERSAO 96         // Uma conversão leva 96 ciclos de clk_adc
+#define ADC_ATRASO_MAX_NS 100000000ull  // Atraso máximo recuperado de uma vez (100 ms)
+
+typedef struct {
+    uint32_t t_ms;
+    uint16_t valor[ADC_CANAIS];
+} linha_csv_t;
+
+adc_hw_t host_adc_hw;
+
+static linha_csv_t *linhas = NULL;
+static size_t num_linhas = 0;
+static size_t cursor = 0;
+static bool carregado = false;
+static uint canal = 0;
+static uint32_t leituras[ADC_CANAIS];
+static uint32_t ruido = 12345;
+
+// Modo contínuo
+static uint32_t round_robin = 0;
+static float divisor = 0.0f;
+static bool fifo_dreq = false;
+static bool rodando = false;
+static uint64_t proxima_ns = 0;
+static uint64_t amostras_fifo = 0;
+static uint64_t amostras_perdidas = 0;
+
+static void adc_carregar_csv(void) {
+    carregado = true;
+    const char *caminho = getenv("ESTACAO_ADC_CSV");
+    if (!caminho || !*caminho)
+        return;
+
+    FILE *f = fopen(caminho, "r");
+    if (!f) {
+        perror(caminho);
+        exit(1);
+    }
+    size_t capacidade = 0;
+    char buf[256];
+    while (fgets(buf, sizeof(buf), f)) {
+        if (!isdigit((unsigned char)buf[0]))
+            continue;
+        if (num_linhas == capacidade) {
+            capacidade = capacidade ? capacidade * 2 : 1024;
+            linhas = realloc(linhas, capacidade * sizeof(linha_csv_t));
+        }
+        linha_csv_t *l = &linhas[num_linhas++];
+        memset(l, 0, sizeof(*l));
+        char *p = buf;
+        l->t_ms = (uint32_t)strtoul(p, &p, 10);
+        for (int c = 0; c < ADC_CANAIS && *p == ','; c++) {
+            unsigned long v = strtoul(p + 1, &p, 10);
+            l->valor[c] = v > 4095 ? 4095 : (uint16_t)v;
+        }
+    }
+    fclose(f);
+}
+
+// Onda triangular entre 'min' e 'max' com o período dado
+static uint16_t triangular(uint32_t t_ms, uint32_t periodo_ms, uint16_t min, uint16_t max) {
+    uint32_t fase = t_ms % periodo_ms;
+    uint32_t meio = periodo_ms / 2;
+    uint32_t subida = fase < meio ? fase : periodo_ms - fase;
+    return min + (uint16_t)((uint64_t)(max - min) * subida / meio);
+}
+
+static uint16_t adc_sintetico(uint c, uint32_t t_ms) {
+    ruido = ruido * 1103515245u + 12345u;
+    int r = (int)((ruido >> 16) % 41) - 20;     // ±20 contagens
+    int v;
+    switch (c) {
+    case 0:  v = triangular(t_ms, 20000, 800, 3800); break;   // Nível da água
+    case 1:  v = triangular(t_ms, 7000, 300, 3700); break;    // Volume de chuva
+    case 4:  v = 876; break;                                  // Sensor de temperatura (~27 °C)
+    default: v = 0; break;
+    }
+    v += r;
+    return v < 0 ? 0 : v > 4095 ? 4095 : (uint16_t)v;
+}
+
+void adc_init(void) {
+    if (!carregado)
+        adc_carregar_csv();
+}
+
+void adc_gpio_init(uint gpio) {
+    (void)gpio;
+}
+
+void adc_select_input(uint input) {
+    canal = input < ADC_CANAIS ? input : 0;
+}
+
+// O canal 4 sempre responde com o valor sintético ou do CSV
+void adc_set_temp_sensor_enabled(bool enable) {
+    (void)enable;
+}
+
+uint adc_get_selected_input(void) {
+    return canal;
+}
+
+static uint16_t adc_valor(uint c, uint32_t t_ms) {
+    leituras[c]++;
+    if (num_linhas == 0)
+        return adc_sintetico(c, t_ms);
+    while (cursor + 1 < num_linhas && linhas[cursor + 1].t_ms <= t_ms)
+        cursor++;
+    return linhas[cursor].valor[c];
+}
+
+uint16_t adc_read(void) {
+    uint16_t v = adc_valor(canal, (uint32_t)(time_us_64() / 1000u));
+    host_trace(TRACE_ADC, canal, v, NULL);
+    return v;
+}
+
+void adc_set_round_robin(uint input_mask) {
+    round_robin = input_mask & ((1u << ADC_CANAIS) - 1);
+}
+
+void adc_set_clkdiv(float clkdiv) {
+    divisor = clkdiv;
+}
+
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift) {
+    (void)dreq_thresh;
+    (void)err_in_fifo;
+    (void)byte_shift;
+    fifo_dreq = en && dreq_en;
+}
+
+void adc_fifo_drain(void) {
+}
+
+void adc_run(bool run) {
+    if (run && !rodando)
+        proxima_ns = time_us_64() * 1000u;
+    rodando = run;
+}
+
+// Próximo canal do round-robin depois de 'c'
+static uint proximo_canal(uint c) {
+    if (!round_robin)
+        return c;
+    do {
+        c = (c + 1) % ADC_CANAIS;
+    } while (!(round_robin & (1u << c)));
+    return c;
+}
+
+void host_adc_avancar(void) {
+    if (!rodando || !fifo_dreq)
+        return;
+    // Período de uma conversão: (1 + div) ciclos de 48 MHz, com no mínimo 96 ciclos
+    double ciclos = divisor + 1.0 < ADC_CICLOS_CONVERSAO ? ADC_CICLOS_CONVERSAO : divisor + 1.0;
+    uint64_t periodo_ns = (uint64_t)(ciclos * 1e9 / clock_get_hz(clk_adc));
+    uint64_t agora_ns = time_us_64() * 1000u;
+    if (agora_ns - proxima_ns > ADC_ATRASO_MAX_NS)
+        proxima_ns = agora_ns - ADC_ATRASO_MAX_NS;
+
+    while (proxima_ns <= agora_ns) {
+        uint16_t v = adc_valor(canal, (uint32_t)(proxima_ns / 1000000u));
+        amostras_fifo++;
+        if (!host_dma_dreq(DREQ_ADC, v))
+            amostras_perdidas++;
+        canal = proximo_canal(canal);
+        proxima_ns += periodo_ns;
+    }
+}
+
+void host_adc_finalizar(FILE *resumo) {
+    fprintf(resumo, "adc_fonte %s\n", num_linhas ? "csv" : "sintetico");
+    for (int c = 0; c < ADC_CANAIS; c++)
+        if (leituras[c])
+            fprintf(resumo, "adc_canal %d leituras %u\n", c, leituras[c]);
+    if (amostras_fifo)
+        fprintf(resumo, "adc_fifo amostras %llu sem_dma %llu\n",
+                (unsigned long long)amostras_fifo, (unsigned long long)amostras_perdidas);
+}
@@ -0,0 +1,202 @@
+// DMA simulada: cada transferência é executada por inteiro no momento em que é
+// disparada. O destino é reconhecido pelo endereço: IC_DATA_CMD de um I2C, FIFO
+// TX de uma PIO ou memória comum. Canais ritmados pelo ADC (DREQ_ADC) ficam
+// ocupados e recebem as amostras uma a uma por host_dma_dreq()
+#include "hardware/dma.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hal_host.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    bool reservado;
+    dma_channel_config config;
+    volatile void *escrita;
+    const volatile void *leitura;
+    uint32_t contagem;          // Valor de recarga (TRANS_COUNT)
+    uint32_t restante;          // Transferências que faltam no canal ritmado
+    bool ocupado;
+    bool irq0_habilitada;
+    bool irq0_pendente;
+} canal_t;
+
+static canal_t canais[NUM_DMA_CHANNELS];
+
+int dma_claim_unused_channel(bool required) {
+    for (int c = 0; c < NUM_DMA_CHANNELS; c++) {
+        if (!canais[c].reservado) {
+            canais[c].reservado = true;
+            return c;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "estacao-sim: sem canais de DMA livres\n");
+        abort();
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) {
+    canais[channel].reservado = false;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    dma_channel_config c = {
+        .size = DMA_SIZE_32,
+        .read_increment = true,
+        .write_increment = false,
+        .dreq = 0x3f,
+        .chain_to = channel,
+    };
+    return c;
+}
+
+static uint32_t ler_elemento(const volatile uint8_t *p, enum dma_channel_transfer_size tam) {
+    switch (tam) {
+    case DMA_SIZE_8:  return *p;
+    case DMA_SIZE_16: return *(const volatile uint16_t *)p;
+    default:          return *(const volatile uint32_t *)p;
+    }
+}
+
+static void executar(uint channel);
+
+// Fim de uma transferência: sinaliza a interrupção e dispara o canal encadeado
+static void concluir(uint channel) {
+    canal_t *c = &canais[channel];
+    c->ocupado = false;
+    if (c->irq0_habilitada) {
+        c->irq0_pendente = true;
+        host_irq_sinalizar(DMA_IRQ_0);
+    }
+    if (c->config.chain_to != channel)
+        executar(c->config.chain_to);
+}
+
+static void executar(uint channel) {
+    canal_t *c = &canais[channel];
+    if (c->config.dreq == DREQ_ADC) {
+        c->restante = c->contagem;
+        c->ocupado = c->restante > 0;
+        return;
+    }
+    uint tam = 1u << c->config.size;
+    const volatile uint8_t *src = c->leitura;
+    volatile uint8_t *dst = c->escrita;
+
+    i2c_inst_t *i2c = NULL;
+    if (dst == (volatile void *)&i2c0->hw.data_cmd)
+        i2c = i2c0;
+    else if (dst == (volatile void *)&i2c1->hw.data_cmd)
+        i2c = i2c1;
+
+    PIO pio = NULL;
+    uint sm = 0;
+    for (uint p = 0; p < 2 && !pio; p++)
+        for (uint s = 0; s < 4; s++)
+            if (dst == (volatile void *)&host_pio_hw[p].txf[s]) {
+                pio = &host_pio_hw[p];
+                sm = s;
+                break;
+            }
+
+    for (uint32_t i = 0; i < c->contagem; i++) {
+        uint32_t v = ler_elemento(src, c->config.size);
+        if (i2c)
+            host_i2c_data_cmd(i2c, v);
+        else if (pio)
+            host_pio_put(pio, sm, v);
+        else
+            memcpy((void *)dst, &v, tam);
+        if (c->config.read_increment)
+            src += tam;
+        if (c->config.write_increment)
+            dst += tam;
+    }
+    c->leitura = src;
+    c->escrita = dst;
+    concluir(channel);
+}
+
+bool host_dma_dreq(uint dreq, uint32_t valor) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+        canal_t *c = &canais[ch];
+        if (!c->ocupado || c->config.dreq != dreq)
+            continue;
+        uint tam = 1u << c->config.size;
+        memcpy((void *)c->escrita, &valor, tam);
+        if (c->config.write_increment)
+            c->escrita = (volatile uint8_t *)c->escrita + tam;
+        if (--c->restante == 0)
+            concluir(ch);
+        return true;
+    }
+    return false;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    canais[channel].config = *config;
+    canais[channel].escrita = write_addr;
+    canais[channel].leitura = read_addr;
+    canais[channel].contagem = transfer_count;
+    if (trigger)
+        executar(channel);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+    canais[channel].leitura = read_addr;
+    canais[channel].contagem = transfer_count;
+    executar(channel);
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger) {
+    canais[channel].leitura = read_addr;
+    if (trigger)
+        executar(channel);
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger) {
+    canais[channel].escrita = write_addr;
+    if (trigger)
+        executar(channel);
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger) {
+    canais[channel].contagem = trans_count;
+    if (trigger)
+        executar(channel);
+}
+
+void dma_channel_start(uint channel) {
+    executar(channel);
+}
+
+void dma_channel_abort(uint channel) {
+    canais[channel].ocupado = false;
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return canais[channel].ocupado;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel) {
+    // Só os canais ritmados pelo ADC ficam ocupados, e esses nunca são esperados assim
+    (void)channel;
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    canais[channel].irq0_habilitada = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+    return canais[channel].irq0_pendente;
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+    canais[channel].irq0_pendente = false;
+}
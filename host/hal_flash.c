@@ -0,0 +1,106 @@
+// Flash simulada: imagem em arquivo, mapeada em memória
+//
+// O arquivo sobrevive entre execuções, como a flash da placa entre partidas.
+// Apagar um setor leva os bytes a 0xFF e programar só consegue limpar bits,
+// como na NOR real, e as duas operações levam o tempo típico do W25Q16.
+//
+// Variáveis de ambiente:
+//   ESTACAO_SIM_FLASH        arquivo da imagem (padrão: flash.bin no diretório de saída)
+//   ESTACAO_SIM_FLASH_CORTE  corta a energia no meio da N-ésima programação de
+//                            página: metade da página é gravada e o processo
+//                            termina sem o encerramento normal
+
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include "pico/stdlib.h"
+#include "hal_host.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define APAGAR_SETOR_US 45000
+#define PROGRAMAR_PAGINA_US 700
+
+static uint8_t *imagem = NULL;
+static uint32_t programacoes = 0;
+static uint32_t corte = 0;
+
+const uint8_t *host_flash_xip(void) {
+    if (imagem)
+        return imagem;
+
+    char padrao[512];
+    const char *caminho = getenv("ESTACAO_SIM_FLASH");
+    if (!caminho || !*caminho)
+        caminho = host_caminho_saida("flash.bin", padrao, sizeof(padrao));
+    const char *c = getenv("ESTACAO_SIM_FLASH_CORTE");
+    if (c && *c)
+        corte = (uint32_t)strtoul(c, NULL, 10);
+
+    int fd = open(caminho, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        perror(caminho);
+        exit(1);
+    }
+    off_t tamanho = lseek(fd, 0, SEEK_END);
+    if (tamanho != PICO_FLASH_SIZE_BYTES) {
+        // Imagem nova: flash inteira apagada
+        static uint8_t apagado[FLASH_SECTOR_SIZE];
+        memset(apagado, 0xFF, sizeof(apagado));
+        bool ok = ftruncate(fd, 0) == 0 && lseek(fd, 0, SEEK_SET) == 0;
+        for (uint32_t i = 0; ok && i < PICO_FLASH_SIZE_BYTES; i += sizeof(apagado))
+            ok = write(fd, apagado, sizeof(apagado)) == (ssize_t)sizeof(apagado);
+        if (!ok) {
+            perror(caminho);
+            exit(1);
+        }
+    }
+    imagem = mmap(NULL, PICO_FLASH_SIZE_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (imagem == MAP_FAILED) {
+        perror("estacao-sim: mmap da flash");
+        exit(1);
+    }
+    return imagem;
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    host_flash_xip();
+    if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        fprintf(stderr, "estacao-sim: apagamento fora de setor (0x%x, %zu)\n", flash_offs, count);
+        abort();
+    }
+    memset(imagem + flash_offs, 0xFF, count);
+    sleep_us((uint64_t)APAGAR_SETOR_US * (count / FLASH_SECTOR_SIZE));
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    host_flash_xip();
+    if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        fprintf(stderr, "estacao-sim: programação fora de página (0x%x, %zu)\n", flash_offs, count);
+        abort();
+    }
+    for (size_t p = 0; p < count; p += FLASH_PAGE_SIZE) {
+        size_t n = FLASH_PAGE_SIZE;
+        bool cortar = corte && ++programacoes == corte;
+        if (cortar)
+            n /= 2;
+        for (size_t i = 0; i < n; i++)
+            imagem[flash_offs + p + i] &= data[p + i];      // Só limpa bits
+        if (cortar) {
+            msync(imagem, PICO_FLASH_SIZE_BYTES, MS_SYNC);
+            fprintf(stderr, "estacao-sim: energia cortada na programação %u (0x%x)\n", programacoes, flash_offs + (uint32_t)p);
+            _exit(3);
+        }
+    }
+    sleep_us((uint64_t)PROGRAMAR_PAGINA_US * (count / FLASH_PAGE_SIZE));
+}
+
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+    (void)enter_exit_timeout_ms;
+    func(param);
+    return PICO_OK;
+}
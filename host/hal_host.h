@@ -0,0 +1,47 @@
+// Interface interna das HALs simuladas (host/)
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Tipos de evento gravados no trace
+typedef enum {
+    TRACE_GPIO,         // a = pino, b = nível
+    TRACE_PWM,          // a = fatia, b = nível (0 = desligado)
+    TRACE_PIO,          // a = máquina de estados, b = palavra enviada
+    TRACE_ADC,          // a = canal, b = leitura
+    TRACE_I2C,          // a = endereço, b = bytes da transação
+    TRACE_TAREFA,       // p = TCB da tarefa que entrou em execução
+    TRACE_FILA,         // p = fila, a = ocupação antes do envio
+} host_trace_tipo_t;
+
+// Grava um evento no buffer de trace. Seguro para chamar de dentro do
+// tratador de sinal do tick da porta POSIX (não usa stdio nem locks)
+void host_trace(host_trace_tipo_t tipo, uint32_t a, uint32_t b, const void *p);
+
+// Duração da simulação quando ESTACAO_SIM_DURACAO_MS não é dada (0 = sem limite)
+extern const uint32_t host_duracao_padrao_ms;
+
+// Caminho de um arquivo dentro do diretório de saída (ESTACAO_SIM_DIR)
+const char *host_caminho_saida(const char *nome, char *buf, size_t tam);
+
+// Marca uma interrupção como pendente; o tratador roda na tarefa de IRQ (hal_irq.c)
+void host_irq_sinalizar(unsigned num);
+
+// Gera as conversões do ADC em modo contínuo até o instante atual (chamada pela tarefa de IRQ)
+void host_adc_avancar(void);
+
+// Modelo do SSD1306 (hal_i2c.c): bytes recebidos no barramento desde o início e
+// GDDRAM atual, página por página (8 x 128 bytes), para os testes. host_i2c_pbm
+// grava a GDDRAM atual no formato dos quadros, sem a linha do instante
+uint64_t host_i2c_bytes(void);
+const uint8_t *host_i2c_gddram(void);
+bool host_i2c_pbm(const char *caminho);
+
+// Funções chamadas no encerramento para gravar os resultados de cada HAL
+void host_i2c_finalizar(FILE *resumo);
+void host_adc_finalizar(FILE *resumo);
+
+#endif
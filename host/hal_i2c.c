@@ -0,0 +1,229 @@
+// I2C simulado com um modelo do controlador SSD1306
+//
+// As transações enviadas ao endereço do display são interpretadas como no
+// hardware: byte de controle 0x80 (um comando), 0x00 (sequência de comandos) ou
+// 0x40 (dados para a GDDRAM), respeitando as janelas de coluna/página e o modo
+// de endereçamento. Um quadro é registrado quando chega uma nova transação
+// depois de um intervalo sem tráfego (o envio de um quadro é uma rajada de
+// transações seguidas). Os quadros são gravados em quadros/NNNNN.pbm.
+
+#include "hardware/i2c.h"
+#include "pico/time.h"
+#include "hal_host.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define SSD1306_ENDERECO 0x3C
+#define LARGURA 128
+#define PAGINAS 8
+#define INTERVALO_QUADRO_US 1000    // Silêncio no barramento que separa dois quadros
+#define MAX_QUADROS 2000
+#define MAX_TRANSACAO 2048
+
+i2c_inst_t i2c0_inst = { .hw = { .status = I2C_IC_STATUS_TFE_BITS }, .index = 0 };
+i2c_inst_t i2c1_inst = { .hw = { .status = I2C_IC_STATUS_TFE_BITS }, .index = 1 };
+
+typedef struct {
+    uint64_t t_us;
+    uint8_t gddram[PAGINAS][LARGURA];
+} quadro_t;
+
+// Estado do controlador
+static uint8_t gddram[PAGINAS][LARGURA];
+static uint8_t modo_enderecamento = 0x02;   // Página (padrão do SSD1306)
+static uint8_t col_ini = 0, col_fim = LARGURA - 1;
+static uint8_t pag_ini = 0, pag_fim = PAGINAS - 1;
+static uint8_t col = 0, pag = 0;
+static bool display_ligado = false;
+static uint8_t cmd_pendente = 0;            // Comando aguardando argumentos
+static uint8_t args_faltando = 0;
+static uint8_t args[2];
+
+// Quadros capturados, sem alocação: o benchmark conta as alocações durante o envio
+static quadro_t quadros[MAX_QUADROS];
+static uint32_t num_quadros = 0;
+static uint32_t quadros_descartados = 0;
+static bool gddram_alterada = false;
+static uint64_t ultimo_trafego_us = 0;
+static uint64_t bytes_total = 0;
+
+// Transação montada pela DMA a partir das palavras do IC_DATA_CMD
+static uint8_t transacao[2][MAX_TRANSACAO];
+static size_t transacao_len[2];
+
+static void registrar_quadro(void) {
+    if (!gddram_alterada)
+        return;
+    gddram_alterada = false;
+    if (num_quadros >= MAX_QUADROS) {
+        quadros_descartados++;
+        return;
+    }
+    quadros[num_quadros].t_us = ultimo_trafego_us;
+    memcpy(quadros[num_quadros].gddram, gddram, sizeof(gddram));
+    num_quadros++;
+}
+
+// Número de argumentos de cada comando usado pelo driver
+static uint8_t num_argumentos(uint8_t cmd) {
+    switch (cmd) {
+    case 0x21: case 0x22:
+        return 2;
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static void executar_comando(uint8_t cmd) {
+    switch (cmd) {
+    case 0x20: modo_enderecamento = args[0] & 0x03; break;
+    case 0x21: col_ini = col = args[0] & 0x7F; col_fim = args[1] & 0x7F; break;
+    case 0x22: pag_ini = pag = args[0] & 0x07; pag_fim = args[1] & 0x07; break;
+    case 0xAE: display_ligado = false; break;
+    case 0xAF: display_ligado = true; break;
+    default: break;
+    }
+}
+
+static void byte_de_comando(uint8_t b) {
+    if (args_faltando > 0) {
+        args[num_argumentos(cmd_pendente) - args_faltando] = b;
+        if (--args_faltando == 0)
+            executar_comando(cmd_pendente);
+        return;
+    }
+    cmd_pendente = b;
+    args_faltando = num_argumentos(b);
+    if (args_faltando == 0)
+        executar_comando(b);
+}
+
+// Escreve na GDDRAM e avança o ponteiro conforme o modo de endereçamento
+static void byte_de_dados(uint8_t b) {
+    if (gddram[pag][col] != b) {
+        gddram[pag][col] = b;
+        gddram_alterada = true;
+    }
+    if (modo_enderecamento == 0x01) {           // Vertical
+        if (pag < pag_fim) {
+            pag++;
+        } else {
+            pag = pag_ini;
+            col = col < col_fim ? col + 1 : col_ini;
+        }
+    } else if (modo_enderecamento == 0x00) {    // Horizontal
+        if (col < col_fim) {
+            col++;
+        } else {
+            col = col_ini;
+            pag = pag < pag_fim ? pag + 1 : pag_ini;
+        }
+    } else {                                    // Página
+        col = col < col_fim ? col + 1 : col_ini;
+    }
+}
+
+static void ssd1306_transacao(const uint8_t *src, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        uint8_t controle = src[i++];
+        bool dados = controle & 0x40;
+        if (controle & 0x80) {              // Co = 1: um único byte e depois outro controle
+            if (i < len)
+                dados ? byte_de_dados(src[i++]) : byte_de_comando(src[i++]);
+        } else {                            // Co = 0: o restante da transação é um fluxo
+            while (i < len)
+                dados ? byte_de_dados(src[i++]) : byte_de_comando(src[i++]);
+        }
+    }
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2c->hw.status = I2C_IC_STATUS_TFE_BITS;
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)i2c;
+    (void)nostop;
+    uint64_t agora = time_us_64();
+    if (agora - ultimo_trafego_us > INTERVALO_QUADRO_US)
+        registrar_quadro();
+    ultimo_trafego_us = agora;
+    bytes_total += len;
+    host_trace(TRACE_I2C, addr, (uint32_t)len, NULL);
+
+    if (addr == SSD1306_ENDERECO)
+        ssd1306_transacao(src, len);
+    return (int)len;
+}
+
+// Palavra escrita no IC_DATA_CMD (pela DMA): acumula até o STOP
+void host_i2c_data_cmd(i2c_inst_t *i2c, uint32_t palavra) {
+    uint8_t *t = transacao[i2c->index];
+    size_t *n = &transacao_len[i2c->index];
+    if (*n < MAX_TRANSACAO)
+        t[(*n)++] = (uint8_t)palavra;
+    if (palavra & I2C_IC_DATA_CMD_STOP_BITS) {
+        i2c_write_blocking(i2c, (uint8_t)i2c->hw.tar, t, *n, false);
+        *n = 0;
+    }
+}
+
+uint64_t host_i2c_bytes(void) {
+    return bytes_total;
+}
+
+const uint8_t *host_i2c_gddram(void) {
+    return &gddram[0][0];
+}
+
+// Pixels de uma GDDRAM em PBM binário (P4): uma linha de 16 bytes por linha de pixels
+static void gravar_pbm(FILE *f, const uint8_t g[PAGINAS][LARGURA]) {
+    for (int y = 0; y < PAGINAS * 8; y++) {
+        for (int x = 0; x < LARGURA; x += 8) {
+            uint8_t b = 0;
+            for (int k = 0; k < 8; k++)
+                if (g[y >> 3][x + k] & (1u << (y & 7)))
+                    b |= 0x80 >> k;
+            fputc(b, f);
+        }
+    }
+}
+
+bool host_i2c_pbm(const char *caminho) {
+    FILE *f = fopen(caminho, "wb");
+    if (!f)
+        return false;
+    fprintf(f, "P4\n%d %d\n", LARGURA, PAGINAS * 8);
+    gravar_pbm(f, gddram);
+    return fclose(f) == 0;
+}
+
+// Grava os quadros em PBM binário (P4), um arquivo por quadro
+void host_i2c_finalizar(FILE *resumo) {
+    registrar_quadro();
+
+    char dir[512];
+    host_caminho_saida("quadros", dir, sizeof(dir));
+    mkdir(dir, 0755);
+    for (uint32_t q = 0; q < num_quadros; q++) {
+        char caminho[600];
+        snprintf(caminho, sizeof(caminho), "%s/%05u.pbm", dir, q);
+        FILE *f = fopen(caminho, "wb");
+        if (!f)
+            continue;
+        fprintf(f, "P4\n# t_us %llu\n%d %d\n", (unsigned long long)quadros[q].t_us, LARGURA, PAGINAS * 8);
+        gravar_pbm(f, quadros[q].gddram);
+        fclose(f);
+    }
+
+    fprintf(resumo, "i2c_bytes %llu\n", (unsigned long long)bytes_total);
+    fprintf(resumo, "display_ligado %d\n", display_ligado);
+    fprintf(resumo, "quadros %u descartados %u\n", num_quadros, quadros_descartados);
+}
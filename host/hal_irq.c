@@ -0,0 +1,63 @@
+// Interrupções simuladas
+//
+// Na porta POSIX só as threads do FreeRTOS podem usar a API do kernel, então os
+// tratadores rodam em uma tarefa de prioridade máxima, criada quando a primeira
+// interrupção é habilitada. A cada tick ela gera o que os periféricos
+// produziram desde a última vez (conversões do ADC) e chama os tratadores das
+// interrupções pendentes, na ordem do número da IRQ.
+#include "hardware/irq.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hal_host.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_TRATADORES 4        // Tratadores compartilhados por IRQ
+
+static irq_handler_t tratadores[NUM_IRQS][MAX_TRATADORES];
+static bool habilitada[NUM_IRQS];
+static uint32_t pendentes;
+static TaskHandle_t tarefa_irq = NULL;
+
+static void host_irq_task(void *params) {
+    (void)params;
+    while (true) {
+        host_adc_avancar();
+        uint32_t p = __atomic_exchange_n(&pendentes, 0, __ATOMIC_ACQ_REL);
+        for (uint num = 0; p; num++, p >>= 1) {
+            if (!(p & 1) || !habilitada[num])
+                continue;
+            for (int k = 0; k < MAX_TRATADORES && tratadores[num][k]; k++)
+                tratadores[num][k]();
+        }
+        vTaskDelay(1);
+    }
+}
+
+void host_irq_sinalizar(unsigned num) {
+    if (num < NUM_IRQS)
+        __atomic_fetch_or(&pendentes, 1u << num, __ATOMIC_RELEASE);
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    tratadores[num][0] = handler;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    (void)order_priority;
+    for (int k = 0; k < MAX_TRATADORES; k++) {
+        if (!tratadores[num][k]) {
+            tratadores[num][k] = handler;
+            return;
+        }
+    }
+    fprintf(stderr, "estacao-sim: tratadores demais na IRQ %u\n", num);
+    abort();
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    habilitada[num] = enabled;
+    if (enabled && !tarefa_irq)
+        xTaskCreate(host_irq_task, "IRQ (sim)", configMINIMAL_STACK_SIZE, NULL, configMAX_PRIORITIES - 1, &tarefa_irq);
+}
@@ -0,0 +1,71 @@
+// PIO simulada: as palavras enviadas às máquinas de estados vão para o trace
+#include "hardware/pio.h"
+#include "hal_host.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define PIO_MEMORIA 32      // Instruções por bloco PIO
+
+pio_hw_t host_pio_hw[2] = { { .index = 0 }, { .index = 1 } };
+
+static uint ocupacao[2];
+static bool sm_reservada[2][4];
+
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+    uint *usadas = &ocupacao[pio->index];
+    if (*usadas + program->length > PIO_MEMORIA) {
+        fprintf(stderr, "estacao-sim: memória de instruções da PIO%u esgotada\n", pio->index);
+        abort();
+    }
+    uint offset = *usadas;
+    *usadas += program->length;
+    return offset;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    for (int sm = 0; sm < 4; sm++) {
+        if (!sm_reservada[pio->index][sm]) {
+            sm_reservada[pio->index][sm] = true;
+            return sm;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "estacao-sim: sem máquinas de estados livres na PIO%u\n", pio->index);
+        abort();
+    }
+    return -1;
+}
+
+void host_pio_put(PIO pio, uint sm, uint32_t data) {
+    host_trace(TRACE_PIO, pio->index * 4 + sm, data, NULL);
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data) {
+    host_pio_put(pio, sm, data);
+}
+
+void pio_gpio_init(PIO pio, uint pin) {
+    (void)pio;
+    (void)pin;
+}
+
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out) {
+    (void)pio;
+    (void)sm;
+    (void)pin_base;
+    (void)pin_count;
+    (void)is_out;
+}
+
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config) {
+    (void)initial_pc;
+    (void)config;
+    sm_reservada[pio->index][sm] = true;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) {
+    (void)pio;
+    (void)sm;
+    (void)enabled;
+}
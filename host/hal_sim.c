@@ -0,0 +1,385 @@
+// HAL simulada: tempo, stdio, GPIO, PWM, relógios e o buffer de trace
+//
+// Variáveis de ambiente:
+//   ESTACAO_SIM_DIR         diretório de saída (padrão: sim_out)
+//   ESTACAO_SIM_DURACAO_MS  duração da simulação; 0 = até o BOOTSEL (padrão: 10000)
+//
+// As escritas binárias na serial (stdio_put_string sem conversão, usada pela
+// telemetria) vão para serial.bin no diretório de saída, para não misturar
+// bytes binários com o texto do terminal
+
+#include "pico/stdlib.h"
+#include "pico/bootrom.h"
+#include "hardware/clocks.h"
+#include "hardware/pwm.h"
+#include "hardware/structs/systick.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hal_host.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TRACE_MAX (1u << 20)    // Eventos guardados até o encerramento
+
+typedef struct {
+    uint64_t t_us;
+    const void *p;
+    uint32_t a, b;
+    uint8_t tipo;
+} registro_t;
+
+static registro_t trace[TRACE_MAX];
+static uint32_t trace_n = 0;
+static volatile int encerrando = 0;
+
+static struct timespec inicio;
+static const char *dir_saida = "sim_out";
+static uint32_t duracao_ms;
+
+// Duração sem ESTACAO_SIM_DURACAO_MS. O benchmark (bench.c) a redefine como 0:
+// ele termina sozinho ao fim do trace
+__attribute__((weak)) const uint32_t host_duracao_padrao_ms = 10000;
+
+static bool gpio_nivel[NUM_BANK0_GPIOS];
+static FILE *serial_bin = NULL;
+
+// ------------------------------------------------------------------ Trace
+
+void host_trace(host_trace_tipo_t tipo, uint32_t a, uint32_t b, const void *p) {
+    if (encerrando)
+        return;
+    uint32_t i = __atomic_fetch_add(&trace_n, 1, __ATOMIC_RELAXED);
+    if (i >= TRACE_MAX)
+        return;
+    trace[i].t_us = time_us_64();
+    trace[i].p = p;
+    trace[i].a = a;
+    trace[i].b = b;
+    trace[i].tipo = tipo;
+}
+
+void host_trace_task_switched_in(void *tcb) {
+    host_trace(TRACE_TAREFA, 0, 0, tcb);
+}
+
+void host_trace_queue(void *fila, unsigned long ocupacao) {
+    host_trace(TRACE_FILA, (uint32_t)ocupacao, 0, fila);
+}
+
+const char *host_caminho_saida(const char *nome, char *buf, size_t tam) {
+    snprintf(buf, tam, "%s/%s", dir_saida, nome);
+    return buf;
+}
+
+// Grava o trace em texto e um resumo do escalonamento e das filas
+static void host_encerrar(void) {
+    encerrando = 1;
+    uint32_t n = trace_n < TRACE_MAX ? trace_n : TRACE_MAX;
+
+    char caminho[512];
+    FILE *f = fopen(host_caminho_saida("trace.txt", caminho, sizeof(caminho)), "w");
+    FILE *resumo = fopen(host_caminho_saida("resumo.txt", caminho, sizeof(caminho)), "w");
+    if (!f || !resumo) {
+        perror("estacao-sim");
+        return;
+    }
+
+    // Contagem de trocas de contexto por tarefa e pico de ocupação por fila
+    enum { MAX_ITENS = 32 };
+    struct { const void *p; uint32_t n; uint32_t max; } tarefas[MAX_ITENS] = {0}, filas[MAX_ITENS] = {0};
+    uint32_t trocas = 0;
+
+    fprintf(f, "# t_us evento argumentos\n");
+    for (uint32_t i = 0; i < n; i++) {
+        const registro_t *r = &trace[i];
+        switch (r->tipo) {
+        case TRACE_GPIO:
+            fprintf(f, "%llu gpio %u %u\n", (unsigned long long)r->t_us, r->a, r->b);
+            break;
+        case TRACE_PWM:
+            fprintf(f, "%llu pwm %u %u\n", (unsigned long long)r->t_us, r->a, r->b);
+            break;
+        case TRACE_PIO:
+            fprintf(f, "%llu pio %u %08x\n", (unsigned long long)r->t_us, r->a, r->b);
+            break;
+        case TRACE_ADC:
+            fprintf(f, "%llu adc %u %u\n", (unsigned long long)r->t_us, r->a, r->b);
+            break;
+        case TRACE_I2C:
+            fprintf(f, "%llu i2c 0x%02x %u\n", (unsigned long long)r->t_us, r->a, r->b);
+            break;
+        case TRACE_TAREFA: {
+            const char *nome = r->p ? pcTaskGetName((TaskHandle_t)r->p) : "?";
+            fprintf(f, "%llu tarefa %s\n", (unsigned long long)r->t_us, nome);
+            trocas++;
+            for (int k = 0; k < MAX_ITENS; k++) {
+                if (tarefas[k].p == r->p || tarefas[k].p == NULL) {
+                    tarefas[k].p = r->p;
+                    tarefas[k].n++;
+                    break;
+                }
+            }
+            break;
+        }
+        case TRACE_FILA:
+            fprintf(f, "%llu fila %p %u\n", (unsigned long long)r->t_us, r->p, r->a);
+            for (int k = 0; k < MAX_ITENS; k++) {
+                if (filas[k].p == r->p || filas[k].p == NULL) {
+                    filas[k].p = r->p;
+                    filas[k].n++;
+                    if (r->a > filas[k].max)
+                        filas[k].max = r->a;
+                    break;
+                }
+            }
+            break;
+        }
+    }
+    fclose(f);
+
+    fprintf(resumo, "duracao_us %llu\n", (unsigned long long)time_us_64());
+    fprintf(resumo, "eventos %u descartados %u\n", n, trace_n > TRACE_MAX ? trace_n - TRACE_MAX : 0);
+    fprintf(resumo, "trocas_de_contexto %u\n", trocas);
+    for (int k = 0; k < MAX_ITENS && tarefas[k].p; k++)
+        fprintf(resumo, "tarefa \"%s\" ativacoes %u\n", pcTaskGetName((TaskHandle_t)tarefas[k].p), tarefas[k].n);
+    for (int k = 0; k < MAX_ITENS && filas[k].p; k++)
+        fprintf(resumo, "fila %p envios %u ocupacao_max %u\n", filas[k].p, filas[k].n, filas[k].max);
+    host_adc_finalizar(resumo);
+    host_i2c_finalizar(resumo);
+    fclose(resumo);
+
+    printf("estacao-sim: resultados em %s/\n", dir_saida);
+}
+
+// Encerra a simulação após ESTACAO_SIM_DURACAO_MS
+static void *host_cronometro(void *arg) {
+    (void)arg;
+    struct timespec t = { duracao_ms / 1000, (long)(duracao_ms % 1000) * 1000000L };
+    while (nanosleep(&t, &t) != 0 && errno == EINTR) {}
+    exit(0);
+    return NULL;
+}
+
+// Executada antes do main(): lê a configuração e prepara a saída
+__attribute__((constructor)) static void host_iniciar(void) {
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+
+    const char *dir = getenv("ESTACAO_SIM_DIR");
+    if (dir && *dir)
+        dir_saida = dir;
+    duracao_ms = host_duracao_padrao_ms;
+    const char *dur = getenv("ESTACAO_SIM_DURACAO_MS");
+    if (dur && *dur)
+        duracao_ms = (uint32_t)strtoul(dur, NULL, 10);
+
+    mkdir(dir_saida, 0755);
+    atexit(host_encerrar);
+
+    if (duracao_ms > 0) {
+        // A thread do cronômetro não pode receber os sinais do tick do FreeRTOS
+        sigset_t todos, anterior;
+        sigfillset(&todos);
+        pthread_sigmask(SIG_SETMASK, &todos, &anterior);
+        pthread_t thread;
+        pthread_create(&thread, NULL, host_cronometro, NULL);
+        pthread_detach(thread);
+        pthread_sigmask(SIG_SETMASK, &anterior, NULL);
+    }
+}
+
+// ------------------------------------------------------------------ Tempo e stdio
+
+uint64_t time_us_64(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)(t.tv_sec - inicio.tv_sec) * 1000000u + (t.tv_nsec - inicio.tv_nsec) / 1000;
+}
+
+static systick_hw_t systick = { .rvr = 0xFFFFFF };
+
+systick_hw_t *host_systick(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    uint64_t ciclos = ((uint64_t)t.tv_sec * 1000000000u + t.tv_nsec) / 8;     // 125 MHz
+    systick.cvr = systick.rvr - (uint32_t)(ciclos % (systick.rvr + 1));
+    return &systick;
+}
+
+// Espera ocupada equivalente à do SDK; retoma após as interrupções do tick
+void sleep_us(uint64_t us) {
+    uint64_t fim = time_us_64() + us;
+    uint64_t agora;
+    while ((agora = time_us_64()) < fim) {
+        uint64_t resto = fim - agora;
+        struct timespec t = { (time_t)(resto / 1000000u), (long)(resto % 1000000u) * 1000L };
+        nanosleep(&t, NULL);
+    }
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000u);
+}
+
+bool stdio_init_all(void) {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return true;
+}
+
+// Leitura não bloqueante do stdin: uma tarefa bloqueada em read() travaria
+// todo o escalonador da porta POSIX
+int getchar_timeout_us(uint32_t timeout_us) {
+    (void)timeout_us;
+    struct pollfd p = { .fd = STDIN_FILENO, .events = POLLIN };
+    unsigned char c;
+    if (poll(&p, 1, 0) == 1 && read(STDIN_FILENO, &c, 1) == 1)
+        return c;
+    return PICO_ERROR_TIMEOUT;
+}
+
+int putchar_raw(int c) {
+    return putchar(c);
+}
+
+int stdio_put_string(const char *s, int len, bool newline, bool cr_translation) {
+    if (cr_translation) {
+        for (int i = 0; i < len; i++)
+            putchar(s[i]);
+        if (newline)
+            putchar('\n');
+        return len;
+    }
+    if (!serial_bin) {
+        char caminho[512];
+        serial_bin = fopen(host_caminho_saida("serial.bin", caminho, sizeof(caminho)), "wb");
+        if (!serial_bin)
+            return 0;
+    }
+    fwrite(s, 1, (size_t)len, serial_bin);
+    if (newline)
+        fputc('\n', serial_bin);
+    fflush(serial_bin);
+    return len;
+}
+
+void stdio_flush(void) {
+    fflush(stdout);
+}
+
+void panic_unsupported(void) {
+    fprintf(stderr, "estacao-sim: panic_unsupported\n");
+    abort();
+}
+
+void reset_usb_boot(uint32_t usb_activity_gpio_pin_mask, uint32_t disable_interface_mask) {
+    (void)usb_activity_gpio_pin_mask;
+    (void)disable_interface_mask;
+    printf("estacao-sim: BOOTSEL solicitado, encerrando\n");
+    exit(0);
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    return clk_index == clk_adc || clk_index == clk_usb ? 48000000u : 125000000u;
+}
+
+// ------------------------------------------------------------------ GPIO e PWM
+
+void gpio_init(uint gpio) {
+    if (gpio < NUM_BANK0_GPIOS)
+        gpio_nivel[gpio] = false;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    (void)gpio;
+    (void)out;
+}
+
+void gpio_put(uint gpio, bool value) {
+    if (gpio >= NUM_BANK0_GPIOS || gpio_nivel[gpio] == value)
+        return;
+    gpio_nivel[gpio] = value;
+    host_trace(TRACE_GPIO, gpio, value, NULL);
+}
+
+// Entradas ficam em nível alto (pull-up, botões soltos)
+bool gpio_get(uint gpio) {
+    return gpio < NUM_BANK0_GPIOS ? gpio_nivel[gpio] : true;
+}
+
+void gpio_pull_up(uint gpio) {
+    if (gpio < NUM_BANK0_GPIOS)
+        gpio_nivel[gpio] = true;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled) {
+    (void)gpio;
+    (void)events;
+    (void)enabled;
+}
+
+// Não há botões na simulação: o callback nunca é chamado
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback) {
+    (void)callback;
+    gpio_set_irq_enabled(gpio, events, enabled);
+}
+
+// Nem pluviômetro: os contadores de pulsos ficam em zero
+void gpio_add_raw_irq_handler(uint gpio, irq_handler_t handler) {
+    (void)gpio;
+    (void)handler;
+}
+
+uint32_t gpio_get_irq_event_mask(uint gpio) {
+    (void)gpio;
+    return 0;
+}
+
+void gpio_acknowledge_irq(uint gpio, uint32_t events) {
+    (void)gpio;
+    (void)events;
+}
+
+static uint16_t pwm_nivel[8][2];
+static bool pwm_ligado[8];
+
+void pwm_set_clkdiv_int_frac(uint slice_num, uint8_t integer, uint8_t fract) {
+    (void)slice_num;
+    (void)integer;
+    (void)fract;
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap) {
+    (void)slice_num;
+    (void)wrap;
+}
+
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level) {
+    if (slice_num >= 8 || chan >= 2 || pwm_nivel[slice_num][chan] == level)
+        return;
+    pwm_nivel[slice_num][chan] = level;
+    if (pwm_ligado[slice_num])
+        host_trace(TRACE_PWM, slice_num, level, NULL);
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t level) {
+    pwm_set_chan_level(pwm_gpio_to_slice_num(gpio), pwm_gpio_to_channel(gpio), level);
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled) {
+    if (slice_num >= 8 || pwm_ligado[slice_num] == enabled)
+        return;
+    pwm_ligado[slice_num] = enabled;
+    host_trace(TRACE_PWM, slice_num, enabled ? pwm_nivel[slice_num][0] | pwm_nivel[slice_num][1] : 0, NULL);
+}
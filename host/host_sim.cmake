@@ -0,0 +1,78 @@
+# Simulação nativa do firmware em Linux
+#
+# Compila DispFilaTasks.c e os drivers de lib/ contra a porta POSIX do FreeRTOS,
+# substituindo o pico-sdk pelas HALs simuladas deste diretório:
+#   - ADC alimentado por um arquivo CSV (ESTACAO_ADC_CSV) ou por um sinal sintético
+#   - I2C decodificado como um SSD1306, com cada quadro salvo em PBM
+#   - GPIO, PWM e PIO registrados em um arquivo de trace
+#
+# Gera também o estacao_bench, que reproduz traces pela cadeia de alerta sem
+# tarefas, para medir o custo de cada etapa (host/bench.c), e os testes de
+# tests/, executados com ctest.
+#
+# Uso: cmake -S . -B build-sim -DESTACAO_HOST_SIM=ON -DFREERTOS_KERNEL_PATH=<kernel>
+
+project(EstacaoSim C)
+
+find_package(Threads REQUIRED)
+
+# Kernel do FreeRTOS com a porta POSIX, configurado por host/FreeRTOSConfig.h
+add_library(freertos_config INTERFACE)
+target_include_directories(freertos_config SYSTEM INTERFACE ${CMAKE_SOURCE_DIR}/host)
+target_compile_definitions(freertos_config INTERFACE projCOVERAGE_TEST=0)
+set(FREERTOS_PORT GCC_POSIX CACHE STRING "Porta do FreeRTOS para a simulação")
+set(FREERTOS_HEAP 4 CACHE STRING "Alocador do FreeRTOS para a simulação")
+add_subdirectory(${FREERTOS_KERNEL_PATH} freertos_kernel)
+
+set(ESTACAO_HAL_SOURCES
+        host/hal_sim.c # Tempo, stdio, GPIO, PWM e trace
+        host/hal_adc.c # ADC com reprodução de CSV
+        host/hal_i2c.c # I2C com modelo do SSD1306 e quadros em PBM
+        host/hal_dma.c # DMA síncrono para os periféricos simulados
+        host/hal_pio.c # PIO da matriz de LED's
+        host/hal_irq.c # Interrupções executadas por uma tarefa de prioridade máxima
+        host/hal_flash.c # Flash em um arquivo mapeado, com corte de energia simulado
+        )
+
+# Benchmark: as mesmas fontes, com o laço de host/bench.c no lugar das tarefas
+set(ESTACAO_BENCH_SOURCES ${ESTACAO_SOURCES})
+list(REMOVE_ITEM ESTACAO_BENCH_SOURCES DispFilaTasks.c)
+
+add_executable(${PROJECT_NAME} ${ESTACAO_SOURCES} ${ESTACAO_HAL_SOURCES})
+add_executable(estacao_bench ${ESTACAO_BENCH_SOURCES} ${ESTACAO_HAL_SOURCES} host/bench.c)
+
+# Alocações das fontes durante o laço do benchmark passam pelos contadores de bench.c
+target_link_options(estacao_bench PRIVATE LINKER:--wrap=malloc,--wrap=calloc,--wrap=realloc)
+
+# Cabeçalhos, definições e bibliotecas comuns aos alvos da simulação
+function(estacao_alvo_host alvo)
+    estacao_font_atlas(${alvo})
+
+    # host/include vem antes para que os cabeçalhos do pico-sdk sejam os simulados
+    target_include_directories(${alvo} PRIVATE
+            ${CMAKE_SOURCE_DIR}/host/include
+            ${CMAKE_SOURCE_DIR}/host
+            ${CMAKE_SOURCE_DIR}
+            ${CMAKE_SOURCE_DIR}/lib
+            )
+
+    # A simulação roda sempre em um núcleo (host/FreeRTOSConfig.h)
+    target_compile_definitions(${alvo} PRIVATE ESTACAO_HOST_SIM=1 ${ESTACAO_DEFINICOES})
+
+    target_link_libraries(${alvo}
+            freertos_kernel
+            freertos_config
+            Threads::Threads
+            )
+endfunction()
+
+estacao_alvo_host(${PROJECT_NAME})
+estacao_alvo_host(estacao_bench)
+
+# Decodificador da telemetria binária: lê serial.bin (ou a serial da placa) e gera CSV
+add_executable(telemetria_decode tools/telemetria_decode.c lib/enquadramento.c)
+target_include_directories(telemetria_decode PRIVATE ${CMAKE_SOURCE_DIR}/lib)
+
+# Testes (ctest --test-dir <build>)
+enable_testing()
+add_subdirectory(tests)
@@ -0,0 +1,28 @@
+// hardware/adc.h simulado: leituras vêm do CSV de reprodução (host/hal_adc.c)
+#ifndef HOST_HARDWARE_ADC_H
+#define HOST_HARDWARE_ADC_H
+
+#include "pico/types.h"
+
+// Só o endereço do FIFO é usado (origem da DMA)
+typedef struct {
+    volatile uint32_t fifo;
+} adc_hw_t;
+extern adc_hw_t host_adc_hw;
+#define adc_hw (&host_adc_hw)
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+uint adc_get_selected_input(void);
+uint16_t adc_read(void);
+void adc_set_temp_sensor_enabled(bool enable);
+
+// Conversão contínua: as amostras vão para a DMA com DREQ_ADC no ritmo do divisor
+void adc_set_round_robin(uint input_mask);
+void adc_set_clkdiv(float clkdiv);
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift);
+void adc_fifo_drain(void);
+void adc_run(bool run);
+
+#endif
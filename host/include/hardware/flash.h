@@ -0,0 +1,19 @@
+// hardware/flash.h simulado: a flash é um arquivo mapeado em memória (host/hal_flash.c)
+#ifndef HOST_HARDWARE_FLASH_H
+#define HOST_HARDWARE_FLASH_H
+
+#include <stddef.h>
+#include "pico/types.h"
+
+#define FLASH_PAGE_SIZE (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+
+// Endereço em que a imagem da flash aparece para leitura (o XIP da placa)
+const uint8_t *host_flash_xip(void);
+#define XIP_BASE ((uintptr_t)host_flash_xip())
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#endif
@@ -0,0 +1,36 @@
+// hardware/gpio.h simulado: mudanças de nível vão para o trace
+#ifndef HOST_HARDWARE_GPIO_H
+#define HOST_HARDWARE_GPIO_H
+
+#include "pico/types.h"
+#include "hardware/irq.h"
+
+#define NUM_BANK0_GPIOS 30
+
+enum gpio_dir { GPIO_IN = 0, GPIO_OUT = 1 };
+
+enum gpio_function {
+    GPIO_FUNC_SPI = 1, GPIO_FUNC_UART = 2, GPIO_FUNC_I2C = 3, GPIO_FUNC_PWM = 4,
+    GPIO_FUNC_SIO = 5, GPIO_FUNC_PIO0 = 6, GPIO_FUNC_PIO1 = 7, GPIO_FUNC_NULL = 0x1f
+};
+
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW = 0x1, GPIO_IRQ_LEVEL_HIGH = 0x2,
+    GPIO_IRQ_EDGE_FALL = 0x4, GPIO_IRQ_EDGE_RISE = 0x8
+};
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+void gpio_pull_up(uint gpio);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback);
+void gpio_add_raw_irq_handler(uint gpio, irq_handler_t handler);
+uint32_t gpio_get_irq_event_mask(uint gpio);
+void gpio_acknowledge_irq(uint gpio, uint32_t events);
+
+#endif
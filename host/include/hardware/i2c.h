@@ -0,0 +1,41 @@
+// hardware/i2c.h simulado: o barramento alimenta um modelo do SSD1306 (host/hal_i2c.c)
+#ifndef HOST_HARDWARE_I2C_H
+#define HOST_HARDWARE_I2C_H
+
+#include <stddef.h>
+#include "pico/types.h"
+
+// Apenas os registradores usados pelos drivers
+typedef struct {
+    volatile uint32_t enable;
+    volatile uint32_t tar;
+    volatile uint32_t data_cmd;
+    volatile uint32_t status;
+    volatile uint32_t tx_abrt_source;
+    volatile uint32_t clr_tx_abrt;
+} i2c_hw_t;
+
+typedef struct i2c_inst {
+    i2c_hw_t hw;
+    uint index;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+#define I2C_IC_DATA_CMD_STOP_BITS    0x00000200u
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x00000400u
+#define I2C_IC_STATUS_ACTIVITY_BITS  0x00000001u
+#define I2C_IC_STATUS_TFE_BITS       0x00000004u
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) { return &i2c->hw; }
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) { return 32 + 2 * i2c->index + (is_tx ? 0 : 1); }
+
+// Usado pela DMA simulada quando o destino é o IC_DATA_CMD de um controlador
+void host_i2c_data_cmd(i2c_inst_t *i2c, uint32_t palavra);
+
+#endif
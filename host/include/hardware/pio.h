@@ -0,0 +1,51 @@
+// hardware/pio.h simulado: palavras enviadas à matriz de LED's vão para o trace
+#ifndef HOST_HARDWARE_PIO_H
+#define HOST_HARDWARE_PIO_H
+
+#include "pico/types.h"
+
+typedef struct {
+    volatile uint32_t txf[4];
+    uint index;
+} pio_hw_t;
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t host_pio_hw[2];
+#define pio0 (&host_pio_hw[0])
+#define pio1 (&host_pio_hw[1])
+
+typedef struct {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+typedef struct {
+    uint32_t clkdiv;
+    uint32_t execctrl;
+    uint32_t shiftctrl;
+    uint32_t pinctrl;
+} pio_sm_config;
+
+enum pio_fifo_join { PIO_FIFO_JOIN_NONE = 0, PIO_FIFO_JOIN_TX = 1, PIO_FIFO_JOIN_RX = 2 };
+
+uint pio_add_program(PIO pio, const pio_program_t *program);
+int pio_claim_unused_sm(PIO pio, bool required);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+static inline uint pio_get_dreq(PIO pio, uint sm, bool is_tx) { return pio->index * 8 + sm + (is_tx ? 0 : 4); }
+
+void pio_gpio_init(PIO pio, uint pin);
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out);
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+
+static inline void sm_config_set_set_pins(pio_sm_config *c, uint set_base, uint set_count) { (void)c; (void)set_base; (void)set_count; }
+static inline void sm_config_set_clkdiv(pio_sm_config *c, float div) { c->clkdiv = (uint32_t)(div * 256); }
+static inline void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join) { (void)c; (void)join; }
+static inline void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold) { (void)c; (void)shift_right; (void)autopull; (void)pull_threshold; }
+static inline void sm_config_set_out_special(pio_sm_config *c, bool sticky, bool has_enable_pin, uint enable_pin_index) { (void)c; (void)sticky; (void)has_enable_pin; (void)enable_pin_index; }
+
+// Usado pela DMA simulada quando o destino é o FIFO TX de uma máquina de estados
+void host_pio_put(PIO pio, uint sm, uint32_t data);
+
+#endif
@@ -0,0 +1,16 @@
+// hardware/pwm.h simulado: mudanças de configuração vão para o trace
+#ifndef HOST_HARDWARE_PWM_H
+#define HOST_HARDWARE_PWM_H
+
+#include "pico/types.h"
+
+static inline uint pwm_gpio_to_slice_num(uint gpio) { return (gpio >> 1) & 7; }
+static inline uint pwm_gpio_to_channel(uint gpio) { return gpio & 1; }
+
+void pwm_set_clkdiv_int_frac(uint slice_num, uint8_t integer, uint8_t fract);
+void pwm_set_wrap(uint slice_num, uint16_t wrap);
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level);
+void pwm_set_gpio_level(uint gpio, uint16_t level);
+void pwm_set_enabled(uint slice_num, bool enabled);
+
+#endif
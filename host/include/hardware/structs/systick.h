@@ -0,0 +1,19 @@
+// hardware/structs/systick.h simulado: o SysTick conta para baixo no ritmo de um
+// clk_sys de 125 MHz derivado do relógio do host, recarregando em 2^24
+#ifndef HOST_HARDWARE_STRUCTS_SYSTICK_H
+#define HOST_HARDWARE_STRUCTS_SYSTICK_H
+
+#include "pico/types.h"
+
+typedef struct {
+    volatile uint32_t csr;
+    volatile uint32_t rvr;
+    volatile uint32_t cvr;
+    volatile uint32_t calib;
+} systick_hw_t;
+
+// Atualiza cvr a partir do tempo do host a cada acesso
+systick_hw_t *host_systick(void);
+#define systick_hw (host_systick())
+
+#endif
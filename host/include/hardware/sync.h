@@ -0,0 +1,8 @@
+// hardware/sync.h simulado: na porta POSIX os ganchos ociosos ficam desligados
+// (host/FreeRTOSConfig.h), então esperar por interrupção não faz nada
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+static inline void __wfi(void) {}
+
+#endif
@@ -0,0 +1,9 @@
+// pico/bootrom.h simulado: o modo BOOTSEL encerra a simulação
+#ifndef HOST_PICO_BOOTROM_H
+#define HOST_PICO_BOOTROM_H
+
+#include "pico/types.h"
+
+void reset_usb_boot(uint32_t usb_activity_gpio_pin_mask, uint32_t disable_interface_mask);
+
+#endif
@@ -0,0 +1,9 @@
+// pico/flash.h simulado: não há outro núcleo nem XIP para pausar
+#ifndef HOST_PICO_FLASH_H
+#define HOST_PICO_FLASH_H
+
+#include "pico/types.h"
+
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms);
+
+#endif
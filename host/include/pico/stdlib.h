@@ -0,0 +1,31 @@
+// pico/stdlib.h simulado para a compilação nativa (host/)
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "pico/types.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+#define PICO_OK 0
+#define PICO_ERROR_TIMEOUT (-1)
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define __not_in_flash_func(f) f
+#define __no_inline_not_in_flash_func(f) f
+#define __time_critical_func(f) f
+
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+int putchar_raw(int c);
+int stdio_put_string(const char *s, int len, bool newline, bool cr_translation);
+void stdio_flush(void);
+
+static inline void tight_loop_contents(void) {}
+static inline uint get_core_num(void) { return 0; }        // A simulação roda em um núcleo
+
+void panic_unsupported(void);
+
+#endif
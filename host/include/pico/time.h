@@ -0,0 +1,14 @@
+// pico/time.h simulado: o tempo é o relógio monotônico desde o início da simulação
+#ifndef HOST_PICO_TIME_H
+#define HOST_PICO_TIME_H
+
+#include "pico/types.h"
+
+uint64_t time_us_64(void);
+static inline uint32_t time_us_32(void) { return (uint32_t)time_us_64(); }
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+#endif
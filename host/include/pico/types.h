@@ -0,0 +1,12 @@
+// Tipos básicos do pico-sdk para a compilação nativa (host/)
+#ifndef HOST_PICO_TYPES_H
+#define HOST_PICO_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#endif
@@ -0,0 +1,26 @@
+// Substituto do cabeçalho gerado pelo pioasm a partir de pio_matriz.pio
+#ifndef HOST_PIO_MATRIZ_PIO_H
+#define HOST_PIO_MATRIZ_PIO_H
+
+#include "hardware/pio.h"
+#include <stddef.h>
+#include "hardware/clocks.h"
+
+// A simulação não executa o programa: só o tamanho é usado para alocar memória da PIO
+static const pio_program_t pio_matriz_program = {
+    .instructions = NULL,
+    .length = 7,
+    .origin = -1,
+};
+
+static inline void pio_matriz_program_init(PIO pio, uint sm, uint offset, uint pin)
+{
+    pio_sm_config c = {0};
+    sm_config_set_clkdiv(&c, clock_get_hz(clk_sys) / 8000000.0);
+    pio_gpio_init(pio, pin);
+    pio_sm_set_consecutive_pindirs(pio, sm, pin, 1, true);
+    pio_sm_init(pio, sm, offset, &c);
+    pio_sm_set_enabled(pio, sm, true);
+}
+
+#endif
@@ -42,8 +42,16 @@
  
  /* Scheduler Related */
  #define configUSE_PREEMPTION                    1
- #define configUSE_TICKLESS_IDLE                 0
- #define configUSE_IDLE_HOOK                     0
+ /* Modo de baixo consumo (ESTACAO_BAIXO_CONSUMO, só com um núcleo): o tick é
+    suspenso enquanto nenhuma tarefa está pronta. Fora dele, os ganchos ociosos
+    dos dois núcleos dormem em WFI até a próxima interrupção (energia.c) */
+ #ifndef ESTACAO_BAIXO_CONSUMO
+ #define ESTACAO_BAIXO_CONSUMO                   0
+ #endif
+ #define configUSE_TICKLESS_IDLE                 ESTACAO_BAIXO_CONSUMO
+ #define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   2
+ #define configUSE_IDLE_HOOK                     ( !ESTACAO_BAIXO_CONSUMO )
+ #define configUSE_PASSIVE_IDLE_HOOK             ( !ESTACAO_BAIXO_CONSUMO )
  #define configUSE_TICK_HOOK                     0
  #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
  #define configMAX_PRIORITIES                    32
@@ -69,20 +77,43 @@
  #define configMESSAGE_BUFFER_LENGTH_TYPE        size_t
  
  /* Memory allocation related definitions. */
- #define configSUPPORT_STATIC_ALLOCATION         0
+ /* Tudo do firmware é alocado estaticamente: tarefas, filas, temporizadores e as
+    pilhas do kernel (DispFilaTasks.c). O heap_4 pequeno fica só para o pico_flash:
+    com FreeRTOS SMP o flash_safe_execute cria (xTaskCreateAffinitySet) e apaga a
+    cada gravação a tarefa que trava o outro núcleo, por isso heap_4 e não heap_1 */
+ #define configSUPPORT_STATIC_ALLOCATION         1
  #define configSUPPORT_DYNAMIC_ALLOCATION        1
- #define configTOTAL_HEAP_SIZE                   (128*1024)
+ #define configTOTAL_HEAP_SIZE                   (4*1024)   /* Pilha e TCB da tarefa de travamento, com folga */
  #define configAPPLICATION_ALLOCATED_HEAP        0
  
  /* Hook function related definitions. */
  #define configCHECK_FOR_STACK_OVERFLOW          0
- #define configUSE_MALLOC_FAILED_HOOK            0
+ #define configUSE_MALLOC_FAILED_HOOK            0     /* Sem heap, o flash_safe_execute só retorna erro */
  #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
  
  /* Run time and task stats gathering related definitions. */
- #define configGENERATE_RUN_TIME_STATS           0
+ #define configGENERATE_RUN_TIME_STATS           1
  #define configUSE_TRACE_FACILITY                1
  #define configUSE_STATS_FORMATTING_FUNCTIONS    0
+
+ /* Fatia de CPU por tarefa medida com o timer de 1 MHz do RP2040, que já está
+    rodando (instrumentacao.c) */
+ #ifndef __ASSEMBLER__
+ #include <stdint.h>
+ uint32_t instr_contador_us(void);
+ void instr_tarefa_ativada(const void *tcb);
+ void energia_dormir_inicio(void);
+ void energia_dormir_fim(void);
+ #endif
+ #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+ #define portGET_RUN_TIME_COUNTER_VALUE()        instr_contador_us()
+
+ /* Tempo dormindo com o tick suspenso */
+ #define configPRE_SLEEP_PROCESSING( x )         energia_dormir_inicio()
+ #define configPOST_SLEEP_PROCESSING( x )        energia_dormir_fim()
+
+ /* Ativações por tarefa no retrato da instrumentação (trocas de contexto) */
+ #define traceTASK_SWITCHED_IN()                 instr_tarefa_ativada( ( const void * ) pxCurrentTCB )
  
  /* Co-routine related definitions. */
  #define configUSE_CO_ROUTINES                   0
@@ -92,7 +123,12 @@
  #define configUSE_TIMERS                        1
  #define configTIMER_TASK_PRIORITY               ( configMAX_PRIORITIES - 1 )
  #define configTIMER_QUEUE_LENGTH                10
- #define configTIMER_TASK_STACK_DEPTH            1024
+ /* Rodam nela os passos do buzzer e da matriz; o da matriz pode esperar a DMA do
+    quadro anterior (matriz_aguardar), mas em laço, sem usar pilha. Os dois caminhos
+    somam menos de 400 bytes com o kernel e o quadro de contexto; a folga cobre a
+    impressão de um configASSERT. A folga real aparece em 'tarefa,Tmr Svc,...' do
+    retrato da instrumentação */
+ #define configTIMER_TASK_STACK_DEPTH            320
  
  /* Interrupt nesting behaviour configuration. */
  /*
@@ -102,9 +138,15 @@
  */
  
  /* SMP port only */
- #define configNUM_CORES                         1
- #define configTICK_CORE                         1
+ /* ESTACAO_NUM_CORES vem do CMake: 2 divide aquisição/alarmes (núcleo 0) e
+    display/matriz/serial (núcleo 1); 1 roda tudo no núcleo 0 */
+ #ifndef ESTACAO_NUM_CORES
+ #define ESTACAO_NUM_CORES                       2
+ #endif
+ #define configNUM_CORES                         ESTACAO_NUM_CORES
+ #define configTICK_CORE                         0
  #define configRUN_MULTIPLE_PRIORITIES           1
+ #define configUSE_CORE_AFFINITY                 ( ESTACAO_NUM_CORES > 1 )
  
  /* RP2040 specific */
  #define configSUPPORT_PICO_SYNC_INTEROP         1
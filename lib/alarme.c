@@ -0,0 +1,175 @@
+#include "alarme.h"
+
+typedef struct {
+    alarme_nivel_t nivel;       // Nível aceito
+    alarme_nivel_t candidato;   // Nível que o valor indica, aguardando a permanência
+    uint64_t desde_us;          // Início da condição do candidato
+} estado_canal_t;
+
+static const alarme_canal_t *tabela;
+static uint8_t num_canais = 0;
+static estado_canal_t estados[ALARME_MAX_CANAIS];
+
+static TaskHandle_t assinantes[ALARME_MAX_ASSINANTES];
+static uint8_t num_assinantes = 0;
+static alarme_evento_t ultimo;              // Lido pelos assinantes em outro núcleo
+
+static volatile alarme_nivel_t nivel_geral = ALARME_NORMAL;
+static bool avaliado = false;
+static uint32_t mudancas = 0;
+static alarme_nivel_t previsto = ALARME_NORMAL;
+static uint16_t previsao_s = 0;             // Lido pelo display em outro núcleo
+
+void alarme_init(const alarme_canal_t *canais, uint8_t num) {
+    tabela = canais;
+    num_canais = num > ALARME_MAX_CANAIS ? ALARME_MAX_CANAIS : num;
+    for (uint8_t i = 0; i < num_canais; i++)
+        estados[i] = (estado_canal_t){ ALARME_NORMAL, ALARME_NORMAL, 0 };
+    nivel_geral = ALARME_NORMAL;
+    avaliado = false;
+    previsto = ALARME_NORMAL;
+}
+
+bool alarme_subscribe(TaskHandle_t tarefa) {
+    if (tarefa == NULL || num_assinantes >= ALARME_MAX_ASSINANTES)
+        return false;
+    assinantes[num_assinantes++] = tarefa;
+    return true;
+}
+
+void alarme_ultimo_evento(alarme_evento_t *ev) {
+    taskENTER_CRITICAL();
+    *ev = ultimo;
+    taskEXIT_CRITICAL();
+}
+
+// Nível indicado pelo valor, partindo do nível 'atual': sobe ao cruzar o limiar de
+// entrada e só desce depois de cair 'histerese' abaixo do limiar do nível atual
+static alarme_nivel_t nivel_alvo(const alarme_canal_t *c, alarme_nivel_t atual, int32_t valor) {
+    alarme_nivel_t n = atual;
+    while (n + 1 < ALARME_NUM_NIVEIS && valor >= c->limiar[n + 1])
+        n++;
+    while (n > ALARME_NORMAL && (int64_t)valor + c->histerese < c->limiar[n])
+        n--;
+    return n;
+}
+
+// Sem cópia por assinante nem fila a esvaziar: várias mudanças antes de uma
+// tarefa rodar resultam em uma única ativação
+static void publicar(const alarme_evento_t *ev) {
+    taskENTER_CRITICAL();
+    ultimo = *ev;
+    taskEXIT_CRITICAL();
+    for (uint8_t i = 0; i < num_assinantes; i++)
+        xTaskNotifyGive(assinantes[i]);
+}
+
+alarme_nivel_t alarme_avaliar(const int32_t valores[], uint64_t timestamp_us) {
+    alarme_nivel_t geral = ALARME_NORMAL;
+
+    for (uint8_t i = 0; i < num_canais; i++) {
+        const alarme_canal_t *c = &tabela[i];
+        estado_canal_t *e = &estados[i];
+        // A histerese parte do candidato: um valor oscilando sobre um limiar não reinicia a permanência
+        alarme_nivel_t alvo = nivel_alvo(c, e->candidato, valores[i]);
+
+        if (alvo == e->nivel) {
+            e->candidato = alvo;                    // Condição voltou: reinicia a contagem
+        } else if (alvo != e->candidato) {
+            e->candidato = alvo;
+            e->desde_us = timestamp_us;
+        }
+        if (e->candidato != e->nivel && timestamp_us - e->desde_us >= (uint64_t)c->permanencia_ms * 1000u)
+            e->nivel = e->candidato;
+
+        if (e->nivel > geral)
+            geral = e->nivel;
+    }
+
+    if (geral != nivel_geral || !avaliado) {
+        if (previsto <= geral)
+            previsto = ALARME_NORMAL;               // A previsão se cumpriu
+        alarme_evento_t ev = {
+            .nivel = geral,
+            .anterior = avaliado ? nivel_geral : geral,
+            .previsto = previsto,
+            .previsao_s = previsao_s,
+            .timestamp_us = timestamp_us,
+        };
+        for (uint8_t i = 0; i < num_canais; i++)
+            ev.niveis[i] = estados[i].nivel;
+        if (avaliado)
+            mudancas++;
+        nivel_geral = geral;
+        avaliado = true;
+        publicar(&ev);
+    }
+    return geral;
+}
+
+bool alarme_proximo(const int32_t valores[]) {
+    for (uint8_t i = 0; i < num_canais; i++) {
+        const estado_canal_t *e = &estados[i];
+        alarme_nivel_t seguinte = e->nivel + 1;
+        if (e->candidato != e->nivel)
+            return true;
+        if (seguinte < ALARME_NUM_NIVEIS && (int64_t)valores[i] + tabela[i].margem >= tabela[i].limiar[seguinte])
+            return true;
+    }
+    return false;
+}
+
+void alarme_prever(alarme_nivel_t nivel, uint16_t segundos, uint64_t timestamp_us) {
+    if (nivel <= nivel_geral || nivel >= ALARME_NUM_NIVEIS)
+        nivel = ALARME_NORMAL;
+    if (!avaliado)
+        return;
+    taskENTER_CRITICAL();
+    bool mudou = nivel != previsto;
+    previsto = nivel;
+    previsao_s = nivel == ALARME_NORMAL ? 0 : segundos;
+    taskEXIT_CRITICAL();
+    if (!mudou)
+        return;
+
+    // Mesmo nível geral, só a previsão muda
+    alarme_evento_t ev;
+    alarme_ultimo_evento(&ev);
+    ev.anterior = ev.nivel;
+    ev.previsto = nivel;
+    ev.previsao_s = previsao_s;
+    ev.timestamp_us = timestamp_us;
+    publicar(&ev);
+}
+
+alarme_nivel_t alarme_previsao(uint16_t *segundos) {
+    taskENTER_CRITICAL();
+    alarme_nivel_t nivel = previsto;
+    if (segundos)
+        *segundos = previsao_s;
+    taskEXIT_CRITICAL();
+    return nivel;
+}
+
+alarme_nivel_t alarme_nivel_atual(void) {
+    return nivel_geral;
+}
+
+alarme_nivel_t alarme_nivel_canal(uint8_t canal) {
+    return canal < num_canais ? estados[canal].nivel : ALARME_NORMAL;
+}
+
+int32_t alarme_limiar(uint8_t canal, alarme_nivel_t nivel) {
+    if (canal >= num_canais || nivel == ALARME_NORMAL || nivel >= ALARME_NUM_NIVEIS)
+        return INT32_MAX;
+    return tabela[canal].limiar[nivel];
+}
+
+uint32_t alarme_mudancas(void) {
+    return mudancas;
+}
+
+const char *alarme_nome_nivel(alarme_nivel_t nivel) {
+    static const char *const nomes[ALARME_NUM_NIVEIS] = { "normal", "aviso", "alerta", "critico" };
+    return nivel < ALARME_NUM_NIVEIS ? nomes[nivel] : "?";
+}
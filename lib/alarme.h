@@ -0,0 +1,88 @@
+#ifndef ALARME_H
+#define ALARME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Avaliador de alarmes com histerese e tempo mínimo de permanência
+//
+// Cada canal tem um limiar de entrada por nível de severidade. Para sair de um
+// nível o valor precisa cair 'histerese' abaixo do limiar desse nível, e qualquer
+// mudança só é aceita depois que a condição se mantém por 'permanencia_ms'.
+// O nível geral é o maior entre os canais; cada mudança dele gera um evento e
+// acorda as tarefas assinantes por notificação direta. Só o evento mais recente
+// é guardado: uma tarefa que acorda depois de duas mudanças vê apenas a última,
+// que é o estado que as saídas devem mostrar. Os valores e limiares estão nas
+// unidades de engenharia dos canais (décimos, lib/canais.h).
+//
+// Além dos níveis confirmados, o evento leva a previsão da tendência
+// (lib/previsao.h): o nível que algum canal deve atingir em breve. Ela é uma
+// severidade de antecipação, que as saídas mostram antes do limiar ser cruzado.
+
+#define ALARME_MAX_CANAIS 6
+#define ALARME_MAX_ASSINANTES 6
+
+typedef enum {
+    ALARME_NORMAL = 0,
+    ALARME_AVISO,
+    ALARME_ALERTA,
+    ALARME_CRITICO,
+    ALARME_NUM_NIVEIS
+} alarme_nivel_t;
+
+// Limiares de um canal sem alarme: nenhum valor entra no aviso
+#define ALARME_SEM_LIMIAR { 0, INT32_MAX, INT32_MAX, INT32_MAX }
+
+typedef struct {
+    const char *nome;
+    int32_t limiar[ALARME_NUM_NIVEIS];      // Valor para entrar em cada nível (limiar[0] não é usado)
+    int32_t histerese;                      // Queda abaixo do limiar necessária para sair do nível
+    int32_t margem;                         // Distância até o limiar seguinte que já pede vigilância
+    uint32_t permanencia_ms;                // Tempo mínimo da nova condição antes de mudar de nível
+} alarme_canal_t;
+
+typedef struct {
+    alarme_nivel_t nivel;
+    alarme_nivel_t anterior;
+    uint8_t niveis[ALARME_MAX_CANAIS];      // Nível de cada canal no momento do evento
+    alarme_nivel_t previsto;                // Nível previsto acima do atual (ALARME_NORMAL: nenhum)
+    uint16_t previsao_s;                    // Segundos até o limiar do nível previsto
+    uint64_t timestamp_us;                  // Instante da amostra que confirmou a mudança
+} alarme_evento_t;
+
+// Define a tabela de canais (não é copiada: deve permanecer válida)
+void alarme_init(const alarme_canal_t *canais, uint8_t num_canais);
+
+// Registra uma tarefa a notificar (xTaskNotifyGive) a cada mudança - antes de
+// iniciar o agendador. A tarefa espera com ulTaskNotifyTake e lê o evento com
+// alarme_ultimo_evento()
+bool alarme_subscribe(TaskHandle_t tarefa);
+
+// Copia o evento mais recente
+void alarme_ultimo_evento(alarme_evento_t *ev);
+
+// Avalia uma amostra (um valor por canal, na ordem da tabela). A primeira
+// avaliação sempre gera um evento, para que as saídas partam de um estado conhecido
+alarme_nivel_t alarme_avaliar(const int32_t valores[], uint64_t timestamp_us);
+
+// Indica se algum canal está a menos da sua margem do limiar do nível seguinte ou
+// com uma mudança esperando a permanência: a aquisição deve ficar na taxa normal
+bool alarme_proximo(const int32_t valores[]);
+
+// Registra a previsão da leitura atual: 'nivel' deve ser atingido em 'segundos'.
+// Previsões que não passam do nível geral são ignoradas. Gera um evento só
+// quando o nível previsto muda; os segundos são atualizados sem acordar ninguém
+void alarme_prever(alarme_nivel_t nivel, uint16_t segundos, uint64_t timestamp_us);
+
+// Nível previsto agora e os segundos até o limiar (para a contagem do display)
+alarme_nivel_t alarme_previsao(uint16_t *segundos);
+
+alarme_nivel_t alarme_nivel_atual(void);
+alarme_nivel_t alarme_nivel_canal(uint8_t canal);   // Nível aceito de um canal
+int32_t alarme_limiar(uint8_t canal, alarme_nivel_t nivel);
+uint32_t alarme_mudancas(void);             // Mudanças do nível geral desde a partida
+const char *alarme_nome_nivel(alarme_nivel_t nivel);
+
+#endif // ALARME_H
@@ -0,0 +1,104 @@
+#include "aquisicao.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "task.h"
+
+// Blocos de amostras brutas: a DMA escreve em um enquanto a tarefa lê o outro
+static uint16_t blocos[2][AQUISICAO_MAX_BLOCO];
+static uint16_t tam_bloco;
+static int dma_chan[2];
+
+static uint8_t ordem[AQUISICAO_MAX_CANAIS];    // Canais na ordem do round-robin
+static uint8_t num_canais;
+static uint16_t decimacao;
+
+static TaskHandle_t consumidor;
+static volatile uint8_t bloco_pronto;
+static volatile uint64_t fim_bloco_us;
+static uint32_t perdidos = 0;
+
+// Fim de um bloco: o canal que terminou já passou a vez ao outro (chain_to). Aqui ele
+// é rearmado para o mesmo bloco (o contador é recarregado sozinho) e o consumidor é avisado
+static void aquisicao_dma_irq(void) {
+    BaseType_t acordou = pdFALSE;
+    for (int i = 0; i < 2; i++) {
+        if (!dma_channel_get_irq0_status(dma_chan[i]))
+            continue;
+        dma_channel_acknowledge_irq0(dma_chan[i]);
+        dma_channel_set_write_addr(dma_chan[i], blocos[i], false);
+        bloco_pronto = i;
+        fim_bloco_us = time_us_64();
+        vTaskNotifyGiveFromISR(consumidor, &acordou);
+    }
+    portYIELD_FROM_ISR(acordou);
+}
+
+bool aquisicao_init(const aquisicao_config_t *cfg) {
+    num_canais = 0;
+    for (uint c = 0; c < AQUISICAO_MAX_CANAIS; c++)
+        if (cfg->canais & (1u << c))
+            ordem[num_canais++] = c;
+    if (num_canais == 0 || cfg->decimacao == 0 || (uint32_t)num_canais * cfg->decimacao > AQUISICAO_MAX_BLOCO)
+        return false;
+    decimacao = cfg->decimacao;
+    tam_bloco = num_canais * decimacao;
+    consumidor = xTaskGetCurrentTaskHandle();
+
+    // ADC: round-robin a partir do primeiro canal, FIFO com DREQ a cada amostra.
+    // Cada conversão dura (1 + div) ciclos de clk_adc (mínimo 96)
+    adc_init();
+    adc_set_temp_sensor_enabled(cfg->canais & (1u << 4));     // ADC4 só lê algo com o sensor ligado
+    adc_select_input(ordem[0]);
+    adc_set_round_robin(cfg->canais);
+    adc_fifo_setup(true, true, 1, false, false);
+    aquisicao_set_taxa(cfg->taxa_hz);
+
+    // Dois canais encadeados um no outro, cada um preenchendo o seu bloco
+    for (int i = 0; i < 2; i++)
+        dma_chan[i] = dma_claim_unused_channel(true);
+    for (int i = 0; i < 2; i++) {
+        dma_channel_config c = dma_channel_get_default_config(dma_chan[i]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_dreq(&c, DREQ_ADC);
+        channel_config_set_chain_to(&c, dma_chan[i ^ 1]);
+        dma_channel_configure(dma_chan[i], &c, blocos[i], &adc_hw->fifo, tam_bloco, false);
+        dma_channel_set_irq0_enabled(dma_chan[i], true);
+    }
+    irq_add_shared_handler(DMA_IRQ_0, aquisicao_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    adc_fifo_drain();
+    dma_channel_start(dma_chan[0]);
+    adc_run(true);
+    return true;
+}
+
+void aquisicao_set_taxa(uint32_t taxa_hz) {
+    adc_set_clkdiv((float)clock_get_hz(clk_adc) / ((float)taxa_hz * num_canais) - 1.0f);
+}
+
+bool aquisicao_aguardar(aquisicao_bloco_t *bloco, TickType_t espera) {
+    uint32_t prontos = ulTaskNotifyTake(pdTRUE, espera);
+    if (prontos == 0)
+        return false;
+    perdidos += prontos - 1;    // Só o bloco mais recente ainda está intacto
+
+    // Média por canal: as amostras se alternam na ordem do round-robin
+    const uint16_t *amostras = blocos[bloco_pronto];
+    uint32_t soma[AQUISICAO_MAX_CANAIS] = {0};
+    for (uint16_t i = 0; i < tam_bloco; i += num_canais)
+        for (uint8_t k = 0; k < num_canais; k++)
+            soma[k] += amostras[i + k] & 0x0FFF;
+
+    for (uint8_t c = 0; c < AQUISICAO_MAX_CANAIS; c++)
+        bloco->media[c] = 0;
+    for (uint8_t k = 0; k < num_canais; k++)
+        bloco->media[ordem[k]] = (uint16_t)((soma[k] + decimacao / 2) / decimacao);
+    bloco->timestamp_us = fim_bloco_us;
+    bloco->blocos_perdidos = perdidos;
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef AQUISICAO_H
+#define AQUISICAO_H
+
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+
+// Aquisição contínua do ADC em round-robin, com DMA e decimação
+//
+// O ADC converte os canais da máscara em sequência, no ritmo do seu divisor, e a
+// DMA leva as amostras do FIFO para dois blocos alternados (ping-pong). Ao fim de
+// cada bloco a tarefa consumidora é notificada uma única vez e calcula a média
+// (boxcar) de cada canal: uma leitura limpa por canal a cada 'decimacao' amostras.
+
+#define AQUISICAO_MAX_CANAIS 5          // ADC0-ADC3 e o sensor de temperatura
+#define AQUISICAO_MAX_BLOCO 3072        // Amostras por bloco (todos os canais; três entradas com decimação 1000)
+
+typedef struct {
+    uint8_t canais;         // Máscara dos canais (bit 0 = ADC0)
+    uint32_t taxa_hz;       // Amostras por segundo em cada canal (1-50 kHz)
+    uint16_t decimacao;     // Amostras somadas em cada leitura de um canal
+} aquisicao_config_t;
+
+typedef struct {
+    uint16_t media[AQUISICAO_MAX_CANAIS];   // Indexado pelo número do canal
+    uint64_t timestamp_us;                  // Fim do bloco
+    uint32_t blocos_perdidos;               // Blocos sobrescritos antes de serem lidos (acumulado)
+} aquisicao_bloco_t;
+
+// Configura o ADC e os canais de DMA e inicia a conversão. Deve ser chamada pela
+// tarefa que vai consumir os blocos: ela é a que recebe as notificações.
+// Retorna false se canais * decimacao não cabe em um bloco
+bool aquisicao_init(const aquisicao_config_t *cfg);
+
+// Muda a taxa de amostragem sem parar a conversão (só o divisor do ADC). Com a
+// mesma decimação, o intervalo entre leituras muda na mesma proporção
+void aquisicao_set_taxa(uint32_t taxa_hz);
+
+// Espera o próximo bloco e devolve a média de cada canal habilitado
+bool aquisicao_aguardar(aquisicao_bloco_t *bloco, TickType_t espera);
+
+#endif
@@ -1,15 +1,154 @@
 #include "buzzer.h"
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/pwm.h"
+#include "FreeRTOS.h"
+#include "timers.h"
 
-// Ativação do buzzer
+// Acionamento do buzzer por PWM com um sequenciador de padrões
+//
+// O tom é gerado pela fatia de PWM do pino (50% de ciclo útil), sem ocupar a CPU.
+// Um temporizador do FreeRTOS avança os passos do padrão a cada BUZZER_PASSO_MS
+// e só fica ativo enquanto há um padrão tocando.
 
-void buzz(uint8_t BUZZER_PIN, uint16_t freq, uint16_t duration) {
-    int period = 1000000 / freq;
-    int pulse = period / 2;
-    int cycles = freq * duration / 1000;
-    for (int j = 0; j < cycles; j++) {
-        gpio_put(BUZZER_PIN, 1);
-        sleep_us(pulse);
-        gpio_put(BUZZER_PIN, 0);
-        sleep_us(pulse);
+#define BUZZER_CONTADOR_HZ 1000000u     // Contador do PWM a 1 MHz: wrap = 1e6 / freq - 1
+
+static const buzzer_passo_t passos_bipe[] = {
+    { 2000, 2000, 100 },
+};
+static const buzzer_passo_t passos_aviso[] = {
+    { 1000, 1000, 100 },
+    {    0,    0, 900 },
+};
+static const buzzer_passo_t passos_alerta[] = {
+    { 1500, 1500, 150 },
+    {    0,    0, 150 },
+};
+static const buzzer_passo_t passos_previsao[] = {
+    { 2500, 2500,   60 },
+    {    0,    0,   80 },
+    { 2500, 2500,   60 },
+    {    0,    0, 2800 },
+};
+static const buzzer_passo_t passos_sirene[] = {
+    {  600, 1200, 500 },
+    { 1200,  600, 500 },
+};
+
+const buzzer_padrao_t BUZZER_BIPE = { passos_bipe, count_of(passos_bipe), false };
+const buzzer_padrao_t BUZZER_AVISO = { passos_aviso, count_of(passos_aviso), true };
+const buzzer_padrao_t BUZZER_ALERTA = { passos_alerta, count_of(passos_alerta), true };
+const buzzer_padrao_t BUZZER_SIRENE = { passos_sirene, count_of(passos_sirene), true };
+const buzzer_padrao_t BUZZER_PREVISAO = { passos_previsao, count_of(passos_previsao), true };
+static const buzzer_padrao_t BUZZER_SILENCIO = { NULL, 0, false };
+
+static uint buzzer_slice;
+static uint buzzer_canal;
+static TimerHandle_t buzzer_timer;
+static StaticTimer_t buzzer_timer_estatico;
+
+// Pedido pendente, lido pelo temporizador no próximo passo
+static const buzzer_padrao_t *volatile pedido = NULL;
+static uint8_t nivel_atual = 0;
+#define NIVEL_AVULSO 0xFF               // Padrão pedido diretamente por buzzer_tocar()
+
+// Estado do sequenciador (só acessado pelo temporizador)
+static const buzzer_padrao_t *padrao = NULL;
+static uint8_t passo = 0;
+static uint16_t t_passo_ms = 0;
+static uint16_t freq_atual = 0;
+
+static void buzzer_frequencia(uint16_t freq) {
+    if (freq == freq_atual)
+        return;
+    freq_atual = freq;
+    if (freq == 0) {
+        pwm_set_chan_level(buzzer_slice, buzzer_canal, 0);
+        return;
+    }
+    uint32_t wrap = BUZZER_CONTADOR_HZ / freq - 1;
+    if (wrap > 0xFFFF)
+        wrap = 0xFFFF;
+    pwm_set_wrap(buzzer_slice, (uint16_t)wrap);
+    pwm_set_chan_level(buzzer_slice, buzzer_canal, (uint16_t)((wrap + 1) / 2));
+}
+
+static void buzzer_passo(TimerHandle_t timer) {
+    taskENTER_CRITICAL();
+    const buzzer_padrao_t *novo = pedido;
+    pedido = NULL;
+    taskEXIT_CRITICAL();
+
+    if (novo) {
+        padrao = novo;
+        passo = 0;
+        t_passo_ms = 0;
+    }
+    if (!padrao || padrao->num_passos == 0) {
+        buzzer_frequencia(0);
+        padrao = NULL;
+        xTimerStop(timer, 0);
+        return;
     }
-}
\ No newline at end of file
+
+    // Passo concluído: avança, repete ou encerra o padrão
+    if (t_passo_ms >= padrao->passos[passo].dur_ms) {
+        t_passo_ms = 0;
+        if (++passo >= padrao->num_passos) {
+            if (!padrao->repetir) {
+                buzzer_frequencia(0);
+                padrao = NULL;
+                xTimerStop(timer, 0);
+                return;
+            }
+            passo = 0;
+        }
+    }
+
+    const buzzer_passo_t *p = &padrao->passos[passo];
+    int32_t delta = (int32_t)p->freq_fim - p->freq_ini;
+    buzzer_frequencia((uint16_t)(p->freq_ini + delta * t_passo_ms / p->dur_ms));
+    t_passo_ms += BUZZER_PASSO_MS;
+}
+
+void buzzer_init(uint pino) {
+    gpio_set_function(pino, GPIO_FUNC_PWM);
+    buzzer_slice = pwm_gpio_to_slice_num(pino);
+    buzzer_canal = pwm_gpio_to_channel(pino);
+
+    // Divisor inteiro para o contador a 1 MHz; a frequência muda só pelo wrap
+    pwm_set_clkdiv_int_frac(buzzer_slice, clock_get_hz(clk_sys) / BUZZER_CONTADOR_HZ, 0);
+    pwm_set_chan_level(buzzer_slice, buzzer_canal, 0);
+    pwm_set_enabled(buzzer_slice, true);
+
+    buzzer_timer = xTimerCreateStatic("Buzzer", pdMS_TO_TICKS(BUZZER_PASSO_MS), pdTRUE, NULL, buzzer_passo, &buzzer_timer_estatico);
+}
+
+static void buzzer_pedir(const buzzer_padrao_t *novo) {
+    taskENTER_CRITICAL();
+    pedido = novo;
+    taskEXIT_CRITICAL();
+    xTimerStart(buzzer_timer, 0);   // Não espera se a fila de comandos estiver cheia
+}
+
+void buzzer_tocar(const buzzer_padrao_t *novo) {
+    nivel_atual = NIVEL_AVULSO;
+    buzzer_pedir(novo ? novo : &BUZZER_SILENCIO);
+}
+
+void buzzer_parar(void) {
+    nivel_atual = 0;
+    buzzer_pedir(&BUZZER_SILENCIO);
+}
+
+void buzzer_severidade(uint8_t nivel) {
+    static const buzzer_padrao_t *const por_nivel[] = {
+        &BUZZER_SILENCIO, &BUZZER_AVISO, &BUZZER_ALERTA, &BUZZER_SIRENE,
+    };
+    if (nivel >= count_of(por_nivel))
+        nivel = count_of(por_nivel) - 1;
+    if (nivel == nivel_atual)
+        return;
+    nivel_atual = nivel;
+    buzzer_pedir(por_nivel[nivel]);
+}
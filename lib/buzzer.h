@@ -4,6 +4,38 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
 
-void buzz(uint8_t BUZZER_PIN, uint16_t freq, uint16_t duration);
+#define BUZZER_PASSO_MS 10      // Resolução do sequenciador de padrões
 
-#endif
\ No newline at end of file
+// Um passo de um padrão: tom de freq_ini a freq_fim (varredura linear) durante dur_ms.
+// Frequência 0 é silêncio
+typedef struct {
+    uint16_t freq_ini;
+    uint16_t freq_fim;
+    uint16_t dur_ms;
+} buzzer_passo_t;
+
+typedef struct {
+    const buzzer_passo_t *passos;
+    uint8_t num_passos;
+    bool repetir;               // Volta ao primeiro passo ao terminar
+} buzzer_padrao_t;
+
+// Padrões de alarme prontos
+extern const buzzer_padrao_t BUZZER_BIPE;        // Bipe único e curto
+extern const buzzer_padrao_t BUZZER_AVISO;       // Um bipe por segundo
+extern const buzzer_padrao_t BUZZER_ALERTA;      // Trem de pulsos rápidos
+extern const buzzer_padrao_t BUZZER_SIRENE;      // Varredura 600-1200 Hz contínua
+extern const buzzer_padrao_t BUZZER_PREVISAO;    // Dois bipes agudos a cada 3 s: limiar previsto
+
+// Configura o pino no PWM e cria o temporizador do sequenciador
+void buzzer_init(uint pino);
+
+// Troca o padrão em execução. Só registra o pedido e retorna: nunca bloqueia
+void buzzer_tocar(const buzzer_padrao_t *padrao);
+void buzzer_parar(void);
+
+// Escolhe o padrão pela severidade (0 = silêncio, 1 = aviso, 2 = alerta, 3 = sirene).
+// Repetir a mesma severidade não reinicia o padrão
+void buzzer_severidade(uint8_t nivel);
+
+#endif
@@ -0,0 +1,173 @@
+#include "canais.h"
+#include "hardware/adc.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include <string.h>
+
+_Static_assert(FILTRO_MAX_CANAIS >= CANAIS_MAX, "filtro.c precisa de estado para todos os canais");
+_Static_assert(PREVISAO_MAX_CANAIS >= CANAIS_MAX, "previsao.c precisa de estado para todos os canais");
+
+static const canal_t *tabela;
+static uint8_t num_canais = 0;
+static alarme_canal_t alarmes[CANAIS_MAX];     // Limiares no formato do avaliador
+static filtro_config_t filtros[CANAIS_MAX];
+static previsao_config_t previsoes[CANAIS_MAX];
+
+// Contadores de pulsos: o total é incrementado na interrupção, e a janela guarda
+// o total no início de cada segundo para descontar o que saiu da janela
+typedef struct {
+    uint8_t gpio;
+    volatile uint32_t total;
+    uint32_t ultimo_us;                         // Último pulso aceito (antirrepique)
+    uint32_t janela[CANAIS_JANELA_S];
+} pulsos_t;
+
+static pulsos_t pulsos[CANAIS_MAX_PULSOS];
+static uint8_t num_pulsos = 0;
+static uint8_t pulsos_do_canal[CANAIS_MAX];     // Índice em pulsos[] de cada canal CANAL_PULSOS
+static uint32_t segundo_atual;
+
+static void canais_gpio_irq(void) {
+    uint32_t agora = time_us_32();
+    for (uint8_t i = 0; i < num_pulsos; i++) {
+        pulsos_t *p = &pulsos[i];
+        uint32_t eventos = gpio_get_irq_event_mask(p->gpio);
+        if (!eventos)
+            continue;
+        gpio_acknowledge_irq(p->gpio, eventos);
+        if (agora - p->ultimo_us >= CANAIS_ANTIRREPIQUE_US) {
+            p->total++;
+            p->ultimo_us = agora;
+        }
+    }
+}
+
+bool canais_init(const canal_t *t, uint8_t num) {
+    if (num == 0 || num > CANAIS_MAX)
+        return false;
+    tabela = t;
+    num_canais = num;
+    num_pulsos = 0;
+
+    for (uint8_t i = 0; i < num; i++) {
+        const canal_t *c = &t[i];
+        alarmes[i] = c->alarme;
+        alarmes[i].nome = c->nome;
+        filtros[i] = c->filtro;
+        previsoes[i] = c->previsao;
+        filtro_init(i, &filtros[i]);
+        previsao_init(i, &previsoes[i]);
+        if (c->fonte == CANAL_ADC) {
+            if (c->entrada >= AQUISICAO_MAX_CANAIS)
+                return false;
+            if (c->entrada < 4)
+                adc_gpio_init(26 + c->entrada);
+        } else {
+            if (num_pulsos >= CANAIS_MAX_PULSOS)
+                return false;
+            pulsos_t *p = &pulsos[num_pulsos];
+            p->gpio = c->entrada;
+            gpio_init(p->gpio);
+            gpio_set_dir(p->gpio, GPIO_IN);
+            gpio_pull_up(p->gpio);              // Contato seco do pluviômetro fecha para o terra
+            gpio_add_raw_irq_handler(p->gpio, canais_gpio_irq);
+            gpio_set_irq_enabled(p->gpio, GPIO_IRQ_EDGE_FALL, true);
+            pulsos_do_canal[i] = num_pulsos++;
+        }
+    }
+    if (num_pulsos)
+        irq_set_enabled(IO_IRQ_BANK0, true);
+    segundo_atual = (uint32_t)(time_us_64() / 1000000u);
+
+    alarme_init(alarmes, num);
+    return true;
+}
+
+void canais_ajustar(uint8_t i, const alarme_canal_t *alarme, const filtro_config_t *filtro,
+                    const previsao_config_t *previsao) {
+    if (i >= num_canais)
+        return;
+    memcpy(alarmes[i].limiar, alarme->limiar, sizeof(alarmes[i].limiar));
+    alarmes[i].histerese = alarme->histerese;
+    alarmes[i].margem = alarme->margem;
+    alarmes[i].permanencia_ms = alarme->permanencia_ms;
+    if (memcmp(&filtros[i], filtro, sizeof(*filtro)) != 0) {
+        filtros[i] = *filtro;
+        filtro_init(i, &filtros[i]);
+    }
+    if (previsoes[i].janela != previsao->janela || previsoes[i].horizonte_s != previsao->horizonte_s) {
+        previsoes[i] = *previsao;
+        previsao_init(i, &previsoes[i]);
+    }
+}
+
+const alarme_canal_t *canais_alarme(uint8_t i) {
+    return i < num_canais ? &alarmes[i] : NULL;
+}
+
+const filtro_config_t *canais_filtro(uint8_t i) {
+    return i < num_canais ? &filtros[i] : NULL;
+}
+
+const previsao_config_t *canais_previsao(uint8_t i) {
+    return i < num_canais ? &previsoes[i] : NULL;
+}
+
+uint8_t canais_num(void) {
+    return num_canais;
+}
+
+const canal_t *canais_canal(uint8_t i) {
+    return i < num_canais ? &tabela[i] : NULL;
+}
+
+uint8_t canais_mascara_adc(void) {
+    uint8_t mascara = 0;
+    for (uint8_t i = 0; i < num_canais; i++)
+        if (tabela[i].fonte == CANAL_ADC)
+            mascara |= 1u << tabela[i].entrada;
+    return mascara;
+}
+
+// Um produto de 64 bits por canal, arredondado; a escala pode ser negativa
+// (sensor de temperatura)
+void canais_converter(const uint32_t brutos[], int32_t valores[]) {
+    for (uint8_t i = 0; i < num_canais; i++) {
+        int64_t v = (int64_t)brutos[i] * tabela[i].escala + (1 << 15);
+        valores[i] = tabela[i].deslocamento + (int32_t)(v >> 16);
+    }
+}
+
+// Pulsos nos últimos CANAIS_JANELA_S segundos. A janela anda pelos segundos
+// inteiros desde a leitura anterior; com leituras de 10 Hz ou 1 Hz a precisão
+// é de um segundo
+static uint32_t pulsos_na_janela(pulsos_t *p, uint32_t segundo) {
+    uint32_t total = p->total;
+    uint32_t passados = segundo - segundo_atual;
+    if (passados > CANAIS_JANELA_S)
+        passados = CANAIS_JANELA_S;
+    for (uint32_t k = passados; k > 0; k--)
+        p->janela[(segundo - k + 1) % CANAIS_JANELA_S] = total;
+    return total - p->janela[(segundo + 1) % CANAIS_JANELA_S];
+}
+
+void canais_ler(const aquisicao_bloco_t *bloco, int32_t valores[]) {
+    uint32_t brutos[CANAIS_MAX];
+    uint32_t segundo = (uint32_t)(bloco->timestamp_us / 1000000u);
+    for (uint8_t i = 0; i < num_canais; i++) {
+        const canal_t *c = &tabela[i];
+        brutos[i] = c->fonte == CANAL_ADC ? bloco->media[c->entrada]
+                                          : pulsos_na_janela(&pulsos[pulsos_do_canal[i]], segundo);
+    }
+    segundo_atual = segundo;
+    canais_converter(brutos, valores);
+}
+
+uint16_t canais_proporcao(uint8_t i, int32_t valor, uint16_t escala) {
+    const canal_t *c = &tabela[i];
+    if (valor <= c->minimo || c->maximo <= c->minimo)
+        return 0;
+    if (valor >= c->maximo)
+        return escala;
+    return (uint16_t)((int64_t)(valor - c->minimo) * escala / (c->maximo - c->minimo));
+}
@@ -0,0 +1,86 @@
+#ifndef CANAIS_H
+#define CANAIS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "alarme.h"
+#include "aquisicao.h"
+#include "filtro.h"
+#include "previsao.h"
+
+// Registro dos canais de medição da estação
+//
+// Cada canal da tabela diz de onde vem a leitura bruta (uma entrada do ADC ou
+// um contador de pulsos em um GPIO), como convertê-la para a unidade de
+// engenharia e quais são os seus limiares de alarme. A tabela é constante e
+// definida pela aplicação; a ordem dela é a ordem dos valores em todo o
+// firmware (barramento, alarmes, telemetria, histórico e display).
+//
+// Os valores convertidos são inteiros em décimos da unidade do canal:
+//   valor = deslocamento + (bruto * escala) >> 16
+// com 'escala' em ponto fixo Q16, sem ponto flutuante no caminho das amostras.
+// Cada canal também escolhe a sua filtragem (filtro.h), aplicada depois da conversão,
+// e a regressão que antecipa os seus alarmes (previsao.h), aplicada ao valor filtrado.
+
+#define CANAIS_MAX ALARME_MAX_CANAIS
+#define CANAIS_MAX_PULSOS 2             // Canais de pulsos (GPIO) simultâneos
+#define CANAIS_JANELA_S 60              // Janela da contagem de pulsos
+#define CANAIS_ANTIRREPIQUE_US 20000    // Pulsos mais próximos que isso são repique do contato
+
+// Escala Q16 de 'decimos' a cada 'contagens' leituras brutas
+#define CANAL_ESCALA(decimos, contagens) ((int32_t)(((int64_t)(decimos) * 65536) / (contagens)))
+
+typedef enum {
+    CANAL_ADC,              // Média do bloco da aquisição; entrada 0-3 (GPIO 26-29) ou 4 (temperatura interna)
+    CANAL_PULSOS,           // Bordas de descida no GPIO 'entrada' nos últimos CANAIS_JANELA_S segundos
+} canal_fonte_t;
+
+typedef struct {
+    const char *nome;       // Identificação nos CSVs e nos alarmes
+    const char *rotulo;     // Texto do display (até 9 caracteres)
+    const char *unidade;    // Unidade do display (até 4 caracteres)
+    canal_fonte_t fonte;
+    uint8_t entrada;
+    int32_t escala;         // Décimos por contagem, em Q16 (CANAL_ESCALA)
+    int32_t deslocamento;   // Décimos somados depois da escala
+    int32_t minimo, maximo; // Faixa do gráfico, em décimos
+    alarme_canal_t alarme;  // Limiares em décimos (o nome vem do canal)
+    filtro_config_t filtro; // Mediana, média exponencial e tendência
+    previsao_config_t previsao; // Janela e horizonte da previsão de cruzamento
+} canal_t;
+
+// Valida a tabela (não é copiada: deve permanecer válida), prepara os GPIOs
+// das entradas e passa os limiares ao avaliador de alarmes, a filtragem ao
+// filtro e a regressão à previsão. Limiares, filtro e previsão são copiados
+// para a RAM, onde podem ser ajustados. Antes do agendador
+bool canais_init(const canal_t *tabela, uint8_t num);
+
+// Ajuste em campo de um canal (config.h): limiares, histerese, margem e
+// permanência valem a partir da próxima avaliação; o filtro e a regressão do
+// canal recomeçam se a configuração deles mudou. Pela tarefa da aquisição,
+// entre duas leituras (ou antes do agendador)
+void canais_ajustar(uint8_t i, const alarme_canal_t *alarme, const filtro_config_t *filtro,
+                    const previsao_config_t *previsao);
+
+// Configuração em uso de um canal
+const alarme_canal_t *canais_alarme(uint8_t i);
+const filtro_config_t *canais_filtro(uint8_t i);
+const previsao_config_t *canais_previsao(uint8_t i);
+
+uint8_t canais_num(void);
+const canal_t *canais_canal(uint8_t i);
+
+// Máscara das entradas do ADC usadas pela tabela (aquisicao_config_t.canais)
+uint8_t canais_mascara_adc(void);
+
+// Converte as leituras brutas de todos os canais de uma vez
+void canais_converter(const uint32_t brutos[], int32_t valores[]);
+
+// Monta as leituras brutas a partir de um bloco da aquisição e dos contadores
+// de pulsos e converte. Um único consumidor (a tarefa da aquisição)
+void canais_ler(const aquisicao_bloco_t *bloco, int32_t valores[]);
+
+// Posição do valor na faixa do canal, de 0 a 'escala'
+uint16_t canais_proporcao(uint8_t i, int32_t valor, uint16_t escala);
+
+#endif // CANAIS_H
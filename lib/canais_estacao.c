@@ -0,0 +1,33 @@
+#include "canais_estacao.h"
+#include "pico/stdlib.h"
+
+// Canais da estação, em décimos da unidade. Os eixos do joystick simulam o volume
+// de chuva e o nível da água em % do fundo de escala; o nível de alerta é o mais
+// perto dos limiares originais do projeto (3480 e 3071 contagens) que um décimo
+// permite: a conversão arredonda e o alerta entra em 3479 e 3070. A margem
+// de vigilância equivale a 300 contagens. A mediana de 5 leituras descarta picos
+// de até 200 ms antes dos alarmes; o nível, que muda devagar, é mais suavizado.
+// A regressão de 5 s sobre a chuva e o nível avisa até 30 s antes do próximo limiar
+const canal_t canais_estacao[] = {
+    { .nome = "chuva", .rotulo = "V. chuva:", .unidade = "%", .fonte = CANAL_ADC, .entrada = 1,
+      .escala = CANAL_ESCALA(1000, 4095), .minimo = 0, .maximo = 1000,
+      .alarme = { .limiar = { 0, 733, 850, 952 }, .histerese = 24, .margem = 73, .permanencia_ms = 300 },
+      .filtro = { .mediana = 5, .ema_k = 1, .tendencia = 10 },
+      .previsao = { .janela = 50, .horizonte_s = 30 } },
+    { .nome = "nivel", .rotulo = "N. agua:", .unidade = "%", .fonte = CANAL_ADC, .entrada = 0,
+      .escala = CANAL_ESCALA(1000, 4095), .minimo = 0, .maximo = 1000,
+      .alarme = { .limiar = { 0, 635, 750, 879 }, .histerese = 24, .margem = 73, .permanencia_ms = 300 },
+      .filtro = { .mediana = 5, .ema_k = 2, .tendencia = 10 },
+      .previsao = { .janela = 50, .horizonte_s = 30 } },
+    // Sensor interno: T = 27 - (V - 0,706) / 0,001721, com V = bruto * 3,3 / 4096
+    { .nome = "temperatura", .rotulo = "Temp.:", .unidade = "C", .fonte = CANAL_ADC, .entrada = 4,
+      .escala = CANAL_ESCALA(-33000, 7049), .deslocamento = 4372, .minimo = -100, .maximo = 600,
+      .alarme = { .limiar = ALARME_SEM_LIMIAR },
+      .filtro = { .mediana = 3, .ema_k = 4 } },
+    // 0,2 mm por basculada; os pulsos de 1 min viram mm/h (x60)
+    { .nome = "pluviometro", .rotulo = "Pluv.:", .unidade = "mm/h", .fonte = CANAL_PULSOS, .entrada = PLUVIOMETRO,
+      .escala = CANAL_ESCALA(120, 1), .minimo = 0, .maximo = 1000,
+      .alarme = { .limiar = { 0, 250, 500, 800 }, .histerese = 120, .margem = 120, .permanencia_ms = 300 },
+      .filtro = { .tendencia = 10 } },                  // A contagem de 1 min já é uma média
+};
+const uint8_t canais_estacao_num = count_of(canais_estacao);
@@ -0,0 +1,15 @@
+#ifndef CANAIS_ESTACAO_H
+#define CANAIS_ESTACAO_H
+
+#include <stdint.h>
+#include "canais.h"
+
+// Tabela de canais da estação, compartilhada pelo firmware e pelo benchmark
+// da simulação nativa (host/bench.c), que reproduz traces pela mesma cadeia
+
+#define PLUVIOMETRO 5           // Pluviômetro de báscula (o botão A simula as basculadas)
+
+extern const canal_t canais_estacao[];
+extern const uint8_t canais_estacao_num;
+
+#endif // CANAIS_ESTACAO_H
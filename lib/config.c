@@ -0,0 +1,447 @@
+#include "config.h"
+#include "historico.h"
+#include "enquadramento.h"
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CONFIG_OFFSET (PICO_FLASH_SIZE_BYTES - HISTORICO_TAMANHO - FLASH_SECTOR_SIZE)
+#define NUM_REGISTROS (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+#define MAGICA 0x4643                       // "CF"
+
+// Registro como gravado na flash, no início de uma página. O CRC cobre a partir
+// de 'assinatura' até o fim de 'config'
+typedef struct {
+    uint16_t magica;
+    uint16_t crc;
+    uint16_t assinatura;                    // Nomes dos canais: outra tabela invalida o registro
+    uint16_t tamanho;                       // sizeof(config_t) de quem gravou
+    config_t config;
+} registro_t;
+
+_Static_assert(sizeof(registro_t) <= FLASH_PAGE_SIZE, "registro_t deve caber em uma página da flash");
+
+typedef enum { ORIGEM_PADRAO, ORIGEM_FLASH, ORIGEM_ALTERADA } origem_t;
+static const char *const nomes_origem[] = { "padrao", "flash", "alterada" };
+
+static config_t padrao;                     // Da tabela dos canais
+static config_t ativa;                      // Em uso; só a aquisição escreve
+static config_t pendente;                   // Publicada pela serial, à espera da aquisição
+static volatile bool ha_pendente = false;
+static uint16_t assinatura;
+
+// Estado da tarefa da serial
+static config_t proposta;
+static origem_t origem = ORIGEM_PADRAO;
+static uint8_t proximo_registro;            // NUM_REGISTROS: setor cheio, apaga antes de gravar
+static char linha[CONFIG_LINHA_MAX + 1];
+static uint8_t tam_linha;
+static bool lendo_linha = false, linha_longa = false;
+
+// Parâmetros de cada canal, na ordem do ':ler'
+typedef enum { TIPO_LIMIAR, TIPO_DECIMOS, TIPO_U8, TIPO_U16, TIPO_U32 } tipo_t;
+
+typedef struct {
+    const char *nome;
+    tipo_t tipo;
+    size_t offset;                          // Em config_canal_t
+} parametro_t;
+
+static const parametro_t parametros[] = {
+    { "aviso", TIPO_LIMIAR, offsetof(config_canal_t, limiar[ALARME_AVISO]) },
+    { "alerta", TIPO_LIMIAR, offsetof(config_canal_t, limiar[ALARME_ALERTA]) },
+    { "critico", TIPO_LIMIAR, offsetof(config_canal_t, limiar[ALARME_CRITICO]) },
+    { "histerese", TIPO_DECIMOS, offsetof(config_canal_t, histerese) },
+    { "margem", TIPO_DECIMOS, offsetof(config_canal_t, margem) },
+    { "permanencia_ms", TIPO_U32, offsetof(config_canal_t, permanencia_ms) },
+    { "mediana", TIPO_U8, offsetof(config_canal_t, filtro.mediana) },
+    { "ema_k", TIPO_U8, offsetof(config_canal_t, filtro.ema_k) },
+    { "tendencia", TIPO_U8, offsetof(config_canal_t, filtro.tendencia) },
+    { "janela", TIPO_U8, offsetof(config_canal_t, previsao.janela) },
+    { "horizonte_s", TIPO_U16, offsetof(config_canal_t, previsao.horizonte_s) },
+};
+
+static const registro_t *registro_flash(uint8_t i) {
+    return (const registro_t *)(XIP_BASE + CONFIG_OFFSET + i * FLASH_PAGE_SIZE);
+}
+
+static uint16_t crc_registro(const registro_t *r) {
+    return enq_crc16((const uint8_t *)r + 4, sizeof(registro_t) - 4);
+}
+
+static bool pagina_apagada(const void *pg) {
+    const uint32_t *p = pg;
+    for (uint i = 0; i < FLASH_PAGE_SIZE / 4; i++)
+        if (p[i] != 0xFFFFFFFFu)
+            return false;
+    return true;
+}
+
+// Valores que o firmware aceita; retorna o motivo da recusa ou NULL
+static const char *validar(const config_t *c) {
+    if (c->periodo_ms < CONFIG_PERIODO_MIN_MS || c->periodo_ms > CONFIG_PERIODO_MAX_MS)
+        return "periodo_ms fora da faixa";
+    for (uint8_t i = 0; i < c->num_canais; i++) {
+        const config_canal_t *k = &c->canais[i];
+        if (k->limiar[ALARME_AVISO] > k->limiar[ALARME_ALERTA] || k->limiar[ALARME_ALERTA] > k->limiar[ALARME_CRITICO])
+            return "limiares fora de ordem";
+        if (k->histerese < 0 || k->margem < 0 || k->permanencia_ms > 600000)
+            return "histerese, margem ou permanencia invalida";
+        const filtro_config_t *f = &k->filtro;
+        if (f->mediana > FILTRO_MEDIANA_MAX || (f->mediana > 1 && f->mediana % 2 == 0) || f->ema_k > 15 ||
+            f->tendencia > FILTRO_TENDENCIA_MAX)
+            return "filtro invalido";
+        if (k->previsao.janela > PREVISAO_JANELA_MAX || k->previsao.horizonte_s > 3600)
+            return "previsao invalida";
+    }
+    return NULL;
+}
+
+static bool registro_valido(const registro_t *r) {
+    return r->magica == MAGICA && r->tamanho == sizeof(config_t) && r->assinatura == assinatura &&
+           r->crc == crc_registro(r) && r->config.num_canais == padrao.num_canais && validar(&r->config) == NULL;
+}
+
+static void aplicar_canais(const config_t *c) {
+    for (uint8_t i = 0; i < c->num_canais; i++) {
+        const config_canal_t *k = &c->canais[i];
+        alarme_canal_t a = { .histerese = k->histerese, .margem = k->margem, .permanencia_ms = k->permanencia_ms };
+        memcpy(a.limiar, k->limiar, sizeof(a.limiar));
+        canais_ajustar(i, &a, &k->filtro, &k->previsao);
+    }
+}
+
+void config_init(uint16_t periodo_padrao_ms) {
+    memset(&padrao, 0, sizeof(padrao));     // Bytes de alinhamento também entram no CRC
+    padrao.periodo_ms = periodo_padrao_ms;
+    padrao.num_canais = canais_num();
+    assinatura = 0;
+    for (uint8_t i = 0; i < padrao.num_canais; i++) {
+        const canal_t *c = canais_canal(i);
+        config_canal_t *k = &padrao.canais[i];
+        memcpy(k->limiar, c->alarme.limiar, sizeof(k->limiar));
+        k->histerese = c->alarme.histerese;
+        k->margem = c->alarme.margem;
+        k->permanencia_ms = c->alarme.permanencia_ms;
+        k->filtro = c->filtro;
+        k->previsao = c->previsao;
+        assinatura = (uint16_t)(assinatura * 31 + enq_crc16((const uint8_t *)c->nome, strlen(c->nome)));
+    }
+    ativa = padrao;
+
+    // O registro válido mais adiante no setor é o mais novo; grava-se no primeiro
+    // apagado depois dele (um registro cortado por falta de energia é pulado)
+    int mais_novo = -1;
+    for (uint8_t i = 0; i < NUM_REGISTROS; i++)
+        if (registro_valido(registro_flash(i)))
+            mais_novo = i;
+    proximo_registro = (uint8_t)(mais_novo + 1);
+    while (proximo_registro < NUM_REGISTROS && !pagina_apagada(registro_flash(proximo_registro)))
+        proximo_registro++;
+    if (mais_novo >= 0) {
+        ativa = registro_flash((uint8_t)mais_novo)->config;
+        origem = ORIGEM_FLASH;
+    }
+    aplicar_canais(&ativa);
+}
+
+uint16_t config_periodo_ms(void) {
+    return ativa.periodo_ms;
+}
+
+// A publicada ainda não aplicada já é a configuração vigente para a serial
+static void config_atual(config_t *c) {
+    taskENTER_CRITICAL();
+    *c = ha_pendente ? pendente : ativa;
+    taskEXIT_CRITICAL();
+}
+
+static void publicar(const config_t *c) {
+    taskENTER_CRITICAL();
+    pendente = *c;
+    ha_pendente = true;
+    taskEXIT_CRITICAL();
+}
+
+bool config_aplicar(uint16_t *periodo_ms) {
+    if (!ha_pendente)
+        return false;
+    taskENTER_CRITICAL();
+    ativa = pendente;
+    ha_pendente = false;
+    taskEXIT_CRITICAL();
+    aplicar_canais(&ativa);
+    *periodo_ms = ativa.periodo_ms;
+    return true;
+}
+
+typedef struct {
+    uint32_t offset;
+    const void *pagina;
+    bool apagar;
+} gravacao_t;
+
+// Roda com as interrupções desligadas e o outro núcleo parado: não pode tocar na flash
+static void __no_inline_not_in_flash_func(gravar_na_flash)(void *param) {
+    const gravacao_t *g = param;
+    if (g->apagar)
+        flash_range_erase(CONFIG_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(g->offset, g->pagina, FLASH_PAGE_SIZE);
+}
+
+static bool gravar(const config_t *c) {
+    static union {
+        registro_t r;
+        uint8_t bytes[FLASH_PAGE_SIZE];
+    } pagina;
+    memset(&pagina, 0xFF, sizeof(pagina));
+    pagina.r.magica = MAGICA;
+    pagina.r.assinatura = assinatura;
+    pagina.r.tamanho = sizeof(config_t);
+    pagina.r.config = *c;
+    pagina.r.crc = crc_registro(&pagina.r);
+
+    // Setor cheio: um corte de energia entre apagar e gravar volta à configuração padrão
+    bool apagar = proximo_registro >= NUM_REGISTROS;
+    uint8_t i = apagar ? 0 : proximo_registro;
+    gravacao_t g = { .offset = CONFIG_OFFSET + i * FLASH_PAGE_SIZE, .pagina = pagina.bytes, .apagar = apagar };
+    if (flash_safe_execute(gravar_na_flash, &g, 100) != PICO_OK)
+        return false;
+    proximo_registro = i + 1;
+    return registro_valido(registro_flash(i));
+}
+
+static void imprimir_decimos(int32_t v) {
+    printf("%s%ld.%ld", v < 0 ? "-" : "", (long)(v < 0 ? -v : v) / 10, (long)(v < 0 ? -v : v) % 10);
+}
+
+static void imprimir(const config_t *c, uint8_t canal, const parametro_t *p) {
+    if (!p) {
+        printf("config,periodo_ms,%u\n", c->periodo_ms);
+        return;
+    }
+    const uint8_t *campo = (const uint8_t *)&c->canais[canal] + p->offset;
+    printf("config,%s.%s,", canais_canal(canal)->nome, p->nome);
+    switch (p->tipo) {
+    case TIPO_LIMIAR:
+        if (*(const int32_t *)campo == INT32_MAX) {
+            printf("-");
+            break;
+        }
+        // fall through
+    case TIPO_DECIMOS:
+        imprimir_decimos(*(const int32_t *)campo);
+        break;
+    case TIPO_U8:
+        printf("%u", *campo);
+        break;
+    case TIPO_U16:
+        printf("%u", *(const uint16_t *)campo);
+        break;
+    case TIPO_U32:
+        printf("%lu", (unsigned long)*(const uint32_t *)campo);
+        break;
+    }
+    printf("\n");
+}
+
+// Valor na unidade do canal, com no máximo uma casa decimal, em décimos
+static bool ler_decimos(const char *s, int32_t *v) {
+    bool negativo = *s == '-';
+    if (negativo || *s == '+')
+        s++;
+    if (*s < '0' || *s > '9')
+        return false;
+    int64_t d = 0;
+    while (*s >= '0' && *s <= '9' && d < INT32_MAX)
+        d = d * 10 + (*s++ - '0');
+    d *= 10;
+    if (*s == '.' && s[1] >= '0' && s[1] <= '9') {
+        d += s[1] - '0';
+        s += 2;
+    }
+    if (*s || d >= INT32_MAX)
+        return false;
+    *v = (int32_t)(negativo ? -d : d);
+    return true;
+}
+
+static bool ler_valor(config_t *c, uint8_t canal, const parametro_t *p, const char *valor) {
+    char *fim;
+    if (!p) {
+        unsigned long v = strtoul(valor, &fim, 10);
+        if (*valor < '0' || *valor > '9' || *fim || v > UINT16_MAX)
+            return false;
+        c->periodo_ms = (uint16_t)v;
+        return true;
+    }
+    uint8_t *campo = (uint8_t *)&c->canais[canal] + p->offset;
+    if (p->tipo == TIPO_LIMIAR && strcmp(valor, "-") == 0) {
+        *(int32_t *)campo = INT32_MAX;
+        return true;
+    }
+    if (p->tipo == TIPO_LIMIAR || p->tipo == TIPO_DECIMOS)
+        return ler_decimos(valor, (int32_t *)campo);
+
+    unsigned long v = strtoul(valor, &fim, 10);
+    if (*valor < '0' || *valor > '9' || *fim)
+        return false;
+    if (p->tipo == TIPO_U8 && v <= UINT8_MAX)
+        *campo = (uint8_t)v;
+    else if (p->tipo == TIPO_U16 && v <= UINT16_MAX)
+        *(uint16_t *)campo = (uint16_t)v;
+    else if (p->tipo == TIPO_U32 && v <= UINT32_MAX)
+        *(uint32_t *)campo = (uint32_t)v;
+    else
+        return false;
+    return true;
+}
+
+// <canal>.<parâmetro> ou periodo_ms. O parâmetro NULL é o período
+static bool achar_chave(const char *chave, uint8_t *canal, const parametro_t **p) {
+    *p = NULL;
+    if (strcmp(chave, "periodo_ms") == 0)
+        return true;
+    const char *ponto = strchr(chave, '.');
+    if (!ponto)
+        return false;
+    for (uint8_t i = 0; i < canais_num(); i++) {
+        const char *nome = canais_canal(i)->nome;
+        if (strlen(nome) != (size_t)(ponto - chave) || strncmp(nome, chave, ponto - chave) != 0)
+            continue;
+        for (size_t j = 0; j < count_of(parametros); j++) {
+            if (strcmp(parametros[j].nome, ponto + 1) == 0) {
+                *canal = i;
+                *p = &parametros[j];
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static char *proxima_palavra(char **s) {
+    while (**s == ' ')
+        (*s)++;
+    if (!**s)
+        return NULL;
+    char *inicio = *s;
+    while (**s && **s != ' ')
+        (*s)++;
+    if (**s)
+        *(*s)++ = '\0';
+    return inicio;
+}
+
+static void comando_ler(char *resto) {
+    config_atual(&proposta);
+    char *chave = proxima_palavra(&resto);
+    uint8_t canal = 0;
+    const parametro_t *p;
+    uint32_t n = 0;
+    if (chave) {
+        if (!achar_chave(chave, &canal, &p)) {
+            printf("# config,erro,chave %s\n", chave);
+            return;
+        }
+        imprimir(&proposta, canal, p);
+        n = 1;
+    } else {
+        imprimir(&proposta, 0, NULL);
+        n = 1;
+        for (uint8_t i = 0; i < proposta.num_canais; i++)
+            for (size_t j = 0; j < count_of(parametros); j++, n++)
+                imprimir(&proposta, i, &parametros[j]);
+    }
+    printf("# config,ok,%lu,%s\n", (unsigned long)n, nomes_origem[origem]);
+}
+
+// Todas as atribuições valem juntas ou nenhuma vale
+static void comando_ajustar(char *resto) {
+    config_atual(&proposta);
+    uint32_t n = 0;
+    char *par;
+    while ((par = proxima_palavra(&resto)) != NULL) {
+        char *igual = strchr(par, '=');
+        uint8_t canal = 0;
+        const parametro_t *p;
+        if (igual)
+            *igual = '\0';
+        if (!igual || !achar_chave(par, &canal, &p)) {
+            printf("# config,erro,chave %s\n", par);
+            return;
+        }
+        if (!ler_valor(&proposta, canal, p, igual + 1)) {
+            printf("# config,erro,valor %s\n", par);
+            return;
+        }
+        n++;
+    }
+    const char *motivo = validar(&proposta);
+    if (n == 0 || motivo) {
+        printf("# config,erro,%s\n", motivo ? motivo : "nada a ajustar");
+        return;
+    }
+    publicar(&proposta);
+    origem = ORIGEM_ALTERADA;
+    printf("# config,ok,%lu\n", (unsigned long)n);
+}
+
+void config_comando(const char *texto) {
+    static char copia[CONFIG_LINHA_MAX + 1];
+    strncpy(copia, texto, CONFIG_LINHA_MAX);
+    copia[CONFIG_LINHA_MAX] = '\0';
+    char *resto = copia;
+    char *comando = proxima_palavra(&resto);
+
+    if (comando && strcmp(comando, "ler") == 0) {
+        comando_ler(resto);
+    } else if (comando && strcmp(comando, "ajustar") == 0) {
+        comando_ajustar(resto);
+    } else if (comando && strcmp(comando, "padrao") == 0) {
+        publicar(&padrao);
+        origem = ORIGEM_PADRAO;
+        printf("# config,ok,padrao\n");
+    } else if (comando && strcmp(comando, "gravar") == 0) {
+        config_atual(&proposta);
+        uint64_t inicio = time_us_64();
+        if (gravar(&proposta)) {
+            origem = ORIGEM_FLASH;
+            printf("# config,ok,gravada,%lu\n", (unsigned long)(time_us_64() - inicio));
+        } else {
+            printf("# config,erro,flash\n");
+        }
+    } else {
+        printf("# config,erro,comando %s\n", comando ? comando : "");
+    }
+}
+
+bool config_caractere(int c) {
+    if (!lendo_linha) {
+        if (c != CONFIG_COMANDO)
+            return false;
+        lendo_linha = true;
+        linha_longa = false;
+        tam_linha = 0;
+        return true;
+    }
+    if (c == '\r' || c == '\n') {
+        lendo_linha = false;
+        linha[tam_linha] = '\0';
+        if (linha_longa)
+            printf("# config,erro,linha longa\n");
+        else
+            config_comando(linha);
+    } else if (tam_linha < CONFIG_LINHA_MAX) {
+        linha[tam_linha++] = (char)c;
+    } else {
+        linha_longa = true;
+    }
+    return true;
+}
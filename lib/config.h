@@ -0,0 +1,69 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "canais.h"
+
+// Configuração ajustável em campo, pela serial (USB CDC)
+//
+// Limiares, histerese, margem e permanência dos alarmes, filtro e previsão de
+// cada canal e o período das leituras podem ser lidos e alterados sem gravar o
+// firmware. Uma linha começando com CONFIG_COMANDO é um comando:
+//
+//   :ler [chave]                 uma linha config,<chave>,<valor> por parâmetro
+//   :ajustar chave=valor ...     valida todas e aplica de uma vez
+//   :gravar                      grava a configuração em uso na flash
+//   :padrao                      volta aos valores da tabela dos canais (sem gravar)
+//
+// As chaves são <canal>.<parâmetro> (ex.: nivel.alerta, chuva.mediana) e
+// periodo_ms. Limiares, histerese e margem são escritos na unidade do canal, com
+// uma casa decimal; '-' desliga um limiar. Cada comando termina com uma linha
+// '# config,ok,...' ou '# config,erro,<motivo>'.
+//
+// A tarefa da serial só publica a nova configuração; a tarefa da aquisição a
+// aplica entre duas leituras (config_aplicar), e nenhuma leitura é avaliada com
+// metade dos parâmetros novos. Na flash a configuração fica em um setor logo
+// antes do histórico, em registros de uma página com CRC gravados em sequência:
+// o mais novo válido vale na partida, e o setor só é apagado quando enche.
+
+#define CONFIG_COMANDO ':'              // Caractere que abre uma linha de comando na serial
+#define CONFIG_LINHA_MAX 96             // Caracteres de uma linha de comando
+#define CONFIG_PERIODO_MIN_MS 20        // Leituras a 50 Hz: ADC a 50 kHz com decimação de 1000
+#define CONFIG_PERIODO_MAX_MS 1000      // O mesmo período da economia
+
+typedef struct {
+    int32_t limiar[ALARME_NUM_NIVEIS];  // Em décimos (limiar[0] não é usado; INT32_MAX desliga)
+    int32_t histerese;
+    int32_t margem;
+    uint32_t permanencia_ms;
+    filtro_config_t filtro;
+    previsao_config_t previsao;
+} config_canal_t;
+
+typedef struct {
+    uint16_t periodo_ms;                // Entre duas leituras publicadas, na taxa normal
+    uint8_t num_canais;
+    config_canal_t canais[CANAIS_MAX];
+} config_t;
+
+// Monta a configuração padrão a partir da tabela já passada a canais_init e do
+// período padrão, e a substitui pela gravada na flash se houver uma válida para
+// a mesma tabela. Aplica o resultado aos canais. Antes do agendador
+void config_init(uint16_t periodo_padrao_ms);
+
+// Alimenta o leitor de comandos com um caractere da serial. Retorna false se o
+// caractere não faz parte de uma linha de comando (ex.: INSTR_COMANDO)
+bool config_caractere(int c);
+
+// Executa uma linha de comando (sem o CONFIG_COMANDO) e imprime a resposta
+void config_comando(const char *linha);
+
+// Chamada pela tarefa da aquisição antes de cada leitura: aplica uma configuração
+// publicada pela serial. Retorna true e o novo período se houve troca
+bool config_aplicar(uint16_t *periodo_ms);
+
+// Período das leituras em uso (o da flash, se houver), para iniciar a aquisição
+uint16_t config_periodo_ms(void);
+
+#endif // CONFIG_H
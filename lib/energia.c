@@ -0,0 +1,103 @@
+#include "energia.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+
+static const char *const nomes_modo[ENERGIA_NUM_MODOS] = { "economia", "vigilancia" };
+
+static energia_config_t config;
+static bool politica = false;
+
+// Estado da política (só a tarefa de aquisição escreve)
+static energia_modo_t modo = ENERGIA_VIGILANCIA;
+static bool tela = true;
+static uint64_t ultima_vigilancia_us;
+static uint64_t desde_modo_us, desde_tela_us;
+static uint64_t tempo_modo_us[ENERGIA_NUM_MODOS];
+static uint64_t tela_apagada_us;
+
+// Sono de cada núcleo: cada um só escreve no próprio contador
+static uint64_t dormindo_us[2];
+static uint32_t inicio_sono[2];
+
+void energia_init(const energia_config_t *cfg) {
+    politica = cfg != NULL;
+    if (cfg)
+        config = *cfg;
+    modo = ENERGIA_VIGILANCIA;          // Parte na taxa normal até a primeira calmaria
+    tela = true;
+    ultima_vigilancia_us = desde_modo_us = desde_tela_us = time_us_64();
+}
+
+energia_modo_t energia_atualizar(bool vigiar, uint64_t agora_us) {
+    if (!politica)
+        return modo;
+    if (vigiar)
+        ultima_vigilancia_us = agora_us;
+    uint64_t calmo_us = agora_us - ultima_vigilancia_us;
+
+    // Entra em vigilância na hora; sai só depois da calmaria
+    energia_modo_t novo = vigiar ? ENERGIA_VIGILANCIA
+                        : calmo_us >= (uint64_t)config.calmaria_ms * 1000u ? ENERGIA_ECONOMIA : modo;
+    if (novo != modo) {
+        tempo_modo_us[modo] += agora_us - desde_modo_us;
+        desde_modo_us = agora_us;
+        modo = novo;
+    }
+
+    bool ligar = calmo_us < (uint64_t)config.tela_ms * 1000u;
+    if (ligar != tela) {
+        if (!tela)
+            tela_apagada_us += agora_us - desde_tela_us;
+        desde_tela_us = agora_us;
+        tela = ligar;
+    }
+    return modo;
+}
+
+bool energia_tela_ligada(void) {
+    return tela;
+}
+
+void energia_dormir_inicio(void) {
+    inicio_sono[get_core_num()] = time_us_32();
+}
+
+void energia_dormir_fim(void) {
+    uint core = get_core_num();
+    dormindo_us[core] += time_us_32() - inicio_sono[core];
+}
+
+// Dorme até a próxima interrupção (tick, DMA ou aviso do outro núcleo)
+void energia_ocioso(void) {
+    energia_dormir_inicio();
+    __wfi();
+    energia_dormir_fim();
+}
+
+#if configUSE_IDLE_HOOK
+void vApplicationIdleHook(void) {
+    energia_ocioso();
+}
+#endif
+
+#if configUSE_PASSIVE_IDLE_HOOK
+void vApplicationPassiveIdleHook(void) {
+    energia_ocioso();
+}
+#endif
+
+void energia_csv(void) {
+    // Os contadores são lidos sem trava: uma leitura pode sair atrasada de um intervalo
+    uint64_t agora = time_us_64();
+    for (energia_modo_t m = 0; m < ENERGIA_NUM_MODOS; m++) {
+        uint64_t us = tempo_modo_us[m] + (m == modo ? agora - desde_modo_us : 0);
+        printf("energia,%s,%llu\n", nomes_modo[m], (unsigned long long)(us / 1000));
+    }
+    uint64_t apagada = tela_apagada_us + (tela ? 0 : agora - desde_tela_us);
+    printf("energia,tela_apagada,%llu\n", (unsigned long long)(apagada / 1000));
+    for (int c = 0; c < ESTACAO_NUM_CORES; c++)
+        printf("energia,nucleo%d_dormindo,%llu\n", c, (unsigned long long)(dormindo_us[c] / 1000));
+}
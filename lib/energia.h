@@ -0,0 +1,45 @@
+#ifndef ENERGIA_H
+#define ENERGIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Modos de consumo da estação e tempo gasto em cada estado
+//
+// Em economia a aquisição roda com o ADC mais lento (menos blocos da DMA, os
+// núcleos dormem entre eles) e o display se apaga depois de um tempo sem
+// alarmes. Qualquer leitura perto de um limiar passa na hora para vigilância,
+// com a taxa normal; a volta à economia só acontece depois de uma calmaria.
+// Os ganchos ociosos do FreeRTOS (ou o tick suspenso no modo de baixo consumo)
+// contam o tempo em que cada núcleo ficou dormindo.
+
+typedef enum {
+    ENERGIA_ECONOMIA = 0,
+    ENERGIA_VIGILANCIA,
+    ENERGIA_NUM_MODOS
+} energia_modo_t;
+
+typedef struct {
+    uint32_t calmaria_ms;       // Sem motivo para vigiar antes de voltar à economia
+    uint32_t tela_ms;           // Sem motivo para vigiar antes de apagar o display
+} energia_config_t;
+
+// Sem configuração (NULL) a estação fica sempre em vigilância e com o display
+// ligado; os tempos continuam sendo contados
+void energia_init(const energia_config_t *cfg);
+
+// Chamada a cada leitura pela tarefa de aquisição: 'vigiar' indica leitura perto
+// de um limiar ou alarme ativo. Retorna o modo em que a aquisição deve ficar
+energia_modo_t energia_atualizar(bool vigiar, uint64_t agora_us);
+
+bool energia_tela_ligada(void);
+
+// Ganchos de sono: ociosidade com WFI (SMP) e tick suspenso (baixo consumo)
+void energia_ocioso(void);
+void energia_dormir_inicio(void);
+void energia_dormir_fim(void);
+
+// Linhas energia,<estado>,<ms> do retrato da instrumentação
+void energia_csv(void);
+
+#endif // ENERGIA_H
@@ -0,0 +1,86 @@
+#include "enquadramento.h"
+#include <string.h>
+
+uint16_t enq_crc16(const uint8_t *dados, size_t n) {
+    uint16_t crc = 0xFFFF;
+    while (n--) {
+        crc ^= (uint16_t)(*dados++) << 8;
+        for (int b = 0; b < 8; b++)
+            crc = crc & 0x8000 ? (uint16_t)(crc << 1) ^ 0x1021 : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+// COBS: cada zero é trocado pela distância até o próximo zero, e o primeiro
+// byte de cada bloco indica onde está o zero seguinte (bloco máximo de 254 bytes)
+static size_t cobs_codificar(const uint8_t *src, size_t n, uint8_t *dst) {
+    size_t saida = 1, codigo_pos = 0;
+    uint8_t codigo = 1;
+    for (size_t i = 0; i < n; i++) {
+        if (src[i] != 0) {
+            dst[saida++] = src[i];
+            codigo++;
+        }
+        if (src[i] == 0 || codigo == 0xFF) {
+            dst[codigo_pos] = codigo;
+            codigo_pos = saida++;
+            codigo = 1;
+        }
+    }
+    dst[codigo_pos] = codigo;
+    return saida;
+}
+
+static size_t cobs_decodificar(const uint8_t *src, size_t n, uint8_t *dst, size_t max) {
+    size_t saida = 0, i = 0;
+    while (i < n) {
+        uint8_t codigo = src[i++];
+        if (codigo == 0 || i + codigo - 1 > n || saida + codigo - 1 > max)
+            return 0;
+        for (uint8_t k = 1; k < codigo; k++)
+            dst[saida++] = src[i++];
+        if (codigo < 0xFF && i < n) {
+            if (saida >= max)
+                return 0;
+            dst[saida++] = 0;
+        }
+    }
+    return saida;
+}
+
+size_t enq_codificar(const enq_registro_t *r, uint8_t saida[ENQ_MAX_QUADRO]) {
+    uint8_t reg[ENQ_MAX_REGISTRO];
+    size_t tam = r->tam < ENQ_MAX_DADOS ? r->tam : ENQ_MAX_DADOS;
+    reg[0] = r->tipo;
+    reg[1] = (uint8_t)r->seq;
+    reg[2] = (uint8_t)(r->seq >> 8);
+    for (int b = 0; b < 4; b++)
+        reg[3 + b] = (uint8_t)(r->t_us >> (8 * b));
+    memcpy(&reg[ENQ_CABECALHO], r->dados, tam);
+    size_t n = ENQ_CABECALHO + tam;
+    uint16_t crc = enq_crc16(reg, n);
+    reg[n++] = (uint8_t)crc;
+    reg[n++] = (uint8_t)(crc >> 8);
+
+    // O zero inicial separa o quadro de qualquer texto impresso antes dele
+    saida[0] = 0;
+    size_t len = 1 + cobs_codificar(reg, n, &saida[1]);
+    saida[len++] = 0;
+    return len;
+}
+
+bool enq_decodificar(const uint8_t *quadro, size_t n, enq_registro_t *r) {
+    uint8_t reg[ENQ_MAX_REGISTRO];
+    size_t len = cobs_decodificar(quadro, n, reg, sizeof(reg));
+    if (len < ENQ_CABECALHO + 2)
+        return false;
+    len -= 2;
+    if (enq_crc16(reg, len) != (uint16_t)(reg[len] | reg[len + 1] << 8))
+        return false;
+    r->tipo = reg[0];
+    r->seq = (uint16_t)(reg[1] | reg[2] << 8);
+    r->t_us = (uint32_t)reg[3] | (uint32_t)reg[4] << 8 | (uint32_t)reg[5] << 16 | (uint32_t)reg[6] << 24;
+    r->tam = (uint8_t)(len - ENQ_CABECALHO);
+    memcpy(r->dados, &reg[ENQ_CABECALHO], r->tam);
+    return true;
+}
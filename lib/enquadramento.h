@@ -0,0 +1,43 @@
+#ifndef ENQUADRAMENTO_H
+#define ENQUADRAMENTO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Enquadramento dos registros binários da telemetria, compartilhado entre o
+// firmware e o decodificador de tools/ (sem dependências do SDK)
+//
+// Registro: tipo (1) | seq (2) | t_us (4) | dados (n) | CRC-16/CCITT (2),
+// campos em little-endian. No fio o registro vai codificado em COBS e cercado
+// por bytes 0x00, de modo que o receptor se ressincroniza no próximo zero.
+
+#define ENQ_CABECALHO 7
+#define ENQ_MAX_DADOS 16
+#define ENQ_MAX_REGISTRO (ENQ_CABECALHO + ENQ_MAX_DADOS + 2)
+#define ENQ_MAX_QUADRO (ENQ_MAX_REGISTRO + ENQ_MAX_REGISTRO / 254 + 3)   // COBS + dois delimitadores
+
+typedef enum {
+    ENQ_AMOSTRA = 1,        // nível de alarme (1), valor de cada canal em décimos (2 cada, com sinal)
+    ENQ_ALARME = 2,         // nível (1), nível anterior (1)
+} enq_tipo_t;
+
+typedef struct {
+    uint8_t tipo;
+    uint16_t seq;           // Contado pelo produtor: saltos indicam registros perdidos
+    uint32_t t_us;          // Instante da amostra (time_us_32)
+    uint8_t tam;
+    uint8_t dados[ENQ_MAX_DADOS];
+} enq_registro_t;
+
+// CRC-16/CCITT-FALSE (polinômio 0x1021, valor inicial 0xFFFF)
+uint16_t enq_crc16(const uint8_t *dados, size_t n);
+
+// Monta o quadro completo (0x00, COBS, 0x00) em 'saida'; retorna o tamanho
+size_t enq_codificar(const enq_registro_t *r, uint8_t saida[ENQ_MAX_QUADRO]);
+
+// Decodifica o conteúdo entre dois zeros. Retorna false se o COBS, o tamanho
+// ou o CRC forem inválidos
+bool enq_decodificar(const uint8_t *quadro, size_t n, enq_registro_t *r);
+
+#endif // ENQUADRAMENTO_H
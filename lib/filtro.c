@@ -0,0 +1,131 @@
+#include "filtro.h"
+#include "instrumentacao.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    const filtro_config_t *cfg;
+    // Mediana: janela na ordem de chegada e a mesma janela ordenada
+    int32_t chegada[FILTRO_MEDIANA_MAX];
+    int32_t ordenada[FILTRO_MEDIANA_MAX];
+    uint8_t n_mediana, proxima;
+    // Média exponencial em Q8 (décimos * 256)
+    int32_t ema;
+    bool ema_iniciada;
+    // Tendência: leituras filtradas e instantes (ms) das últimas 'tendencia' + 1
+    int32_t historico[FILTRO_TENDENCIA_MAX + 1];
+    uint32_t t_ms[FILTRO_TENDENCIA_MAX + 1];
+    uint8_t n_tendencia, cabeca;
+} estado_filtro_t;
+
+static estado_filtro_t estados[FILTRO_MAX_CANAIS];
+static filtro_stats_t stats;
+static uint64_t ciclos_total;
+
+void filtro_init(uint8_t canal, const filtro_config_t *cfg) {
+    if (canal >= FILTRO_MAX_CANAIS)
+        return;
+    memset(&estados[canal], 0, sizeof(estados[canal]));
+    estados[canal].cfg = cfg;
+}
+
+#ifndef ESTACAO_SEM_FILTRO
+// Troca a leitura mais antiga pela nova mantendo a janela ordenada: só os
+// valores entre as duas posições andam, no máximo FILTRO_MEDIANA_MAX
+static int32_t mediana(estado_filtro_t *e, uint8_t janela, int32_t x) {
+    if (janela > FILTRO_MEDIANA_MAX)
+        janela = FILTRO_MEDIANA_MAX;
+    uint8_t n = e->n_mediana;
+    if (n == janela) {
+        int32_t velho = e->chegada[e->proxima];
+        uint8_t i = 0;
+        while (e->ordenada[i] != velho)
+            i++;
+        for (; i + 1 < n; i++)
+            e->ordenada[i] = e->ordenada[i + 1];
+        n--;
+    }
+    uint8_t i = n;
+    while (i > 0 && e->ordenada[i - 1] > x) {
+        e->ordenada[i] = e->ordenada[i - 1];
+        i--;
+    }
+    e->ordenada[i] = x;
+    e->n_mediana = n + 1;
+    e->chegada[e->proxima] = x;
+    e->proxima = (e->proxima + 1) % janela;
+    return e->ordenada[e->n_mediana / 2];
+}
+
+// y += (x - y) * 2^-k, com 8 bits de fração para a média não travar em passos pequenos
+static int32_t media_exponencial(estado_filtro_t *e, uint8_t k, int32_t x) {
+    if (!e->ema_iniciada) {
+        e->ema = x * 256;
+        e->ema_iniciada = true;
+    }
+    e->ema += (x * 256 - e->ema) >> k;
+    return (e->ema + 128) >> 8;
+}
+#endif
+
+// Variação em décimos por minuto entre a leitura atual e a de 'janela' leituras atrás
+static int32_t tendencia(estado_filtro_t *e, uint8_t janela, int32_t y, uint32_t t_ms) {
+    if (janela > FILTRO_TENDENCIA_MAX)
+        janela = FILTRO_TENDENCIA_MAX;
+    uint8_t tamanho = janela + 1;
+    e->cabeca = (e->cabeca + 1) % tamanho;
+    e->historico[e->cabeca] = y;
+    e->t_ms[e->cabeca] = t_ms;
+    if (e->n_tendencia < tamanho)
+        e->n_tendencia++;
+    if (e->n_tendencia < tamanho)
+        return 0;
+    uint8_t antiga = (e->cabeca + 1) % tamanho;
+    uint32_t dt = t_ms - e->t_ms[antiga];
+    return dt ? (int32_t)((int64_t)(y - e->historico[antiga]) * 60000 / dt) : 0;
+}
+
+void filtro_processar(const int32_t entrada[], int32_t saida[], int32_t tendencias[], uint8_t num,
+                      uint64_t timestamp_us) {
+    uint32_t inicio = instr_ciclos();
+    uint32_t t_ms = (uint32_t)(timestamp_us / 1000);
+    if (num > FILTRO_MAX_CANAIS)
+        num = FILTRO_MAX_CANAIS;
+
+    for (uint8_t i = 0; i < num; i++) {
+        estado_filtro_t *e = &estados[i];
+        const filtro_config_t *c = e->cfg;
+        int32_t y = entrada[i];
+        if (c == NULL) {
+            saida[i] = y;
+            tendencias[i] = 0;
+            continue;
+        }
+#ifndef ESTACAO_SEM_FILTRO
+        if (c->mediana > 1)
+            y = mediana(e, c->mediana, y);
+        if (c->ema_k)
+            y = media_exponencial(e, c->ema_k, y);
+#endif
+        saida[i] = y;
+        tendencias[i] = c->tendencia ? tendencia(e, c->tendencia, y, t_ms) : 0;
+    }
+
+    uint32_t ciclos = instr_ciclos_desde(inicio);
+    ciclos_total += ciclos;
+    stats.leituras++;
+    if (ciclos > stats.ciclos_max)
+        stats.ciclos_max = ciclos;
+}
+
+filtro_stats_t filtro_stats(void) {
+    filtro_stats_t s = stats;
+    s.ciclos_medios = s.leituras ? (uint32_t)(ciclos_total / s.leituras) : 0;
+    return s;
+}
+
+void filtro_csv(void) {
+    filtro_stats_t s = filtro_stats();
+    printf("filtro,%lu,%lu,%lu\n", (unsigned long)s.leituras, (unsigned long)s.ciclos_medios,
+           (unsigned long)s.ciclos_max);
+}
@@ -0,0 +1,46 @@
+#ifndef FILTRO_H
+#define FILTRO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Filtragem das leituras entre a conversão dos canais e a avaliação dos alarmes
+//
+// Cada canal passa por uma mediana deslizante (remove picos isolados), depois
+// por uma média móvel exponencial em ponto fixo (suaviza o ruído) e, por fim,
+// alimenta um estimador de tendência: a variação entre a leitura filtrada atual
+// e a de 'tendencia' leituras atrás, em décimos por minuto. O estado de todos os
+// canais é estático e o custo por leitura é limitado pelas janelas máximas.
+// Com ESTACAO_SEM_FILTRO a mediana e a média são ignoradas, para comparar o
+// número de alarmes com e sem filtro no mesmo trace.
+
+#define FILTRO_MAX_CANAIS 6
+#define FILTRO_MEDIANA_MAX 7            // Janela máxima da mediana
+#define FILTRO_TENDENCIA_MAX 16         // Leituras máximas entre os pontos da tendência
+
+typedef struct {
+    uint8_t mediana;        // Leituras na janela da mediana (ímpar; 0 ou 1 desliga)
+    uint8_t ema_k;          // Média exponencial com alfa = 2^-ema_k (0 desliga)
+    uint8_t tendencia;      // Leituras entre os pontos da tendência (0 desliga)
+} filtro_config_t;
+
+typedef struct {
+    uint32_t leituras;              // Chamadas de filtro_processar
+    uint32_t ciclos_medios;         // Ciclos de CPU por leitura (todos os canais)
+    uint32_t ciclos_max;
+} filtro_stats_t;
+
+// Configura o filtro de um canal e zera o estado (não copia: deve permanecer válida)
+void filtro_init(uint8_t canal, const filtro_config_t *cfg);
+
+// Filtra uma leitura de todos os canais. 'tendencias' recebe décimos por minuto
+// (0 enquanto a janela não enche ou sem estimador). Um único chamador
+void filtro_processar(const int32_t entrada[], int32_t saida[], int32_t tendencias[], uint8_t num,
+                      uint64_t timestamp_us);
+
+filtro_stats_t filtro_stats(void);
+
+// Linha do retrato da instrumentação: filtro,<leituras>,<ciclos_medios>,<ciclos_max>
+void filtro_csv(void);
+
+#endif // FILTRO_H
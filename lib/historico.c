@@ -0,0 +1,272 @@
+#include "historico.h"
+#include "enquadramento.h"
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "queue.h"
+#include <string.h>
+
+#define HISTORICO_OFFSET (PICO_FLASH_SIZE_BYTES - HISTORICO_TAMANHO)
+#define NUM_PAGINAS (HISTORICO_TAMANHO / FLASH_PAGE_SIZE)
+#define PAGINAS_POR_SETOR (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+#define MAGICA 0x4D48                       // "HM" (páginas "HL", de dois canais, são ignoradas)
+#define CABECALHO 16
+
+// Página como gravada na flash. O CRC cobre o cabeçalho a partir de 'seq' e os
+// 'tam' bytes de registros
+typedef struct {
+    uint16_t magica;
+    uint16_t crc;
+    uint32_t seq;
+    uint16_t boot;
+    uint8_t tam;
+    uint8_t reservado;
+    uint32_t t_ms;                          // Instante do primeiro registro
+    uint8_t dados[FLASH_PAGE_SIZE - CABECALHO];
+} pagina_t;
+
+_Static_assert(sizeof(pagina_t) == FLASH_PAGE_SIZE, "pagina_t deve ocupar uma página da flash");
+
+// Páginas na RAM: a atual é do produtor; as cheias esperam a gravadora
+static pagina_t paginas[HISTORICO_PAGINAS_RAM];
+static QueueHandle_t livres;
+static QueueHandle_t cheias;
+static StaticQueue_t livres_estatica, cheias_estatica;
+static uint8_t livres_itens[HISTORICO_PAGINAS_RAM], cheias_itens[HISTORICO_PAGINAS_RAM];
+static uint8_t atual;
+
+// Estado do produtor (deltas da página atual)
+static uint32_t t_anterior;
+static int32_t valores_anteriores[CANAIS_MAX];
+
+// Estado da gravadora
+static uint32_t escrita;                    // Próxima página a gravar
+static uint32_t proxima_seq;
+static historico_stats_t stats;
+
+static const pagina_t *pagina_flash(uint32_t i) {
+    return (const pagina_t *)(XIP_BASE + HISTORICO_OFFSET + i * FLASH_PAGE_SIZE);
+}
+
+static uint16_t crc_pagina(const pagina_t *pg) {
+    return enq_crc16((const uint8_t *)pg + 4, CABECALHO - 4 + pg->tam);
+}
+
+static bool pagina_valida(const pagina_t *pg) {
+    return pg->magica == MAGICA && pg->tam <= sizeof(pg->dados) && pg->crc == crc_pagina(pg);
+}
+
+static bool pagina_apagada(const pagina_t *pg) {
+    const uint32_t *p = (const uint32_t *)pg;
+    for (uint i = 0; i < FLASH_PAGE_SIZE / 4; i++)
+        if (p[i] != 0xFFFFFFFFu)
+            return false;
+    return true;
+}
+
+bool historico_init(void) {
+    uint64_t inicio = time_us_64();
+    bool achou = false;
+    uint32_t cabeca = 0, maior_seq = 0;
+    uint16_t boot = 0;
+    for (uint32_t i = 0; i < NUM_PAGINAS; i++) {
+        const pagina_t *pg = pagina_flash(i);
+        if (!pagina_valida(pg))
+            continue;
+        stats.paginas_validas++;
+        if (!achou || (int32_t)(pg->seq - maior_seq) > 0) {
+            achou = true;
+            maior_seq = pg->seq;
+            cabeca = i;
+            boot = pg->boot;
+        }
+    }
+
+    // Continua depois da página mais nova. As seguintes do mesmo setor só servem
+    // se ainda estiverem apagadas (uma gravação cortada deixa lixo); ao chegar ao
+    // início de um setor ele é apagado antes da primeira página
+    uint32_t p = achou ? cabeca + 1 : 0;
+    while (p % PAGINAS_POR_SETOR != 0 && !pagina_apagada(pagina_flash(p)))
+        p++;
+    escrita = p % NUM_PAGINAS;
+    proxima_seq = achou ? maior_seq + 1 : 0;
+    stats.boot = achou ? boot + 1 : 0;
+    stats.varredura_us = (uint32_t)(time_us_64() - inicio);
+
+    livres = xQueueCreateStatic(HISTORICO_PAGINAS_RAM, sizeof(uint8_t), livres_itens, &livres_estatica);
+    cheias = xQueueCreateStatic(HISTORICO_PAGINAS_RAM, sizeof(uint8_t), cheias_itens, &cheias_estatica);
+    if (livres == NULL || cheias == NULL)
+        return false;
+    memset(paginas, 0xFF, sizeof(paginas));
+    for (uint8_t i = 1; i < HISTORICO_PAGINAS_RAM; i++)
+        xQueueSend(livres, &i, 0);
+    atual = 0;
+    paginas[atual].tam = 0;
+    return true;
+}
+
+static uint8_t *varint(uint8_t *p, uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)v | 0x80;
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+void historico_fechar_pagina(void) {
+    if (paginas[atual].tam == 0)
+        return;
+    uint8_t nova;
+    if (xQueueReceive(livres, &nova, 0) != pdTRUE) {
+        stats.paginas_perdidas++;           // Gravadora atrasada: reaproveita a página
+    } else {
+        xQueueSend(cheias, &atual, 0);
+        atual = nova;
+    }
+    paginas[atual].tam = 0;
+}
+
+// Amostra: tipo | dt | n | n deltas com zigzag. Alarme: tipo | dt | nível | anterior
+static void registrar(historico_tipo_t tipo, uint64_t timestamp_us, const int32_t *valores, uint8_t num) {
+    uint32_t t_ms = (uint32_t)(timestamp_us / 1000);
+    for (int tentativa = 0; tentativa < 2; tentativa++) {
+        pagina_t *pg = &paginas[atual];
+        if (pg->tam == 0) {                 // Página nova: deltas partem de zero
+            pg->t_ms = t_ms;
+            t_anterior = t_ms;
+            memset(valores_anteriores, 0, sizeof(valores_anteriores));
+        }
+
+        uint8_t reg[3 + 5 * (CANAIS_MAX + 1)];
+        uint8_t *p = reg;
+        *p++ = tipo;
+        p = varint(p, t_ms - t_anterior);
+        if (tipo == HISTORICO_AMOSTRA) {
+            *p++ = num;
+            for (uint8_t i = 0; i < num; i++)
+                p = varint(p, zigzag(valores[i] - valores_anteriores[i]));
+        } else {
+            *p++ = (uint8_t)valores[0];
+            *p++ = (uint8_t)valores[1];
+        }
+
+        size_t n = p - reg;
+        if (pg->tam + n <= sizeof(pg->dados)) {
+            memcpy(&pg->dados[pg->tam], reg, n);
+            pg->tam += n;
+            t_anterior = t_ms;
+            if (tipo == HISTORICO_AMOSTRA)
+                memcpy(valores_anteriores, valores, num * sizeof(int32_t));
+            return;
+        }
+        historico_fechar_pagina();
+    }
+}
+
+void historico_amostra(uint64_t timestamp_us, const int32_t valores[], uint8_t num) {
+    registrar(HISTORICO_AMOSTRA, timestamp_us, valores, num > CANAIS_MAX ? CANAIS_MAX : num);
+}
+
+void historico_alarme(uint64_t timestamp_us, uint8_t nivel, uint8_t anterior) {
+    const int32_t mudanca[] = { nivel, anterior };
+    registrar(HISTORICO_ALARME, timestamp_us, mudanca, 2);
+}
+
+typedef struct {
+    uint32_t offset;
+    const pagina_t *pagina;
+    bool apagar;
+} gravacao_t;
+
+// Roda com as interrupções desligadas e o outro núcleo parado: não pode tocar na flash
+static void __no_inline_not_in_flash_func(gravar_na_flash)(void *param) {
+    const gravacao_t *g = param;
+    if (g->apagar)
+        flash_range_erase(g->offset, FLASH_SECTOR_SIZE);
+    flash_range_program(g->offset, (const uint8_t *)g->pagina, FLASH_PAGE_SIZE);
+}
+
+void historico_gravar(TickType_t espera) {
+    uint8_t i;
+    if (xQueueReceive(cheias, &i, espera) != pdTRUE)
+        return;
+
+    pagina_t *pg = &paginas[i];
+    pg->magica = MAGICA;
+    pg->seq = proxima_seq++;
+    pg->boot = stats.boot;
+    pg->reservado = 0xFF;
+    pg->crc = crc_pagina(pg);
+
+    gravacao_t g = {
+        .offset = HISTORICO_OFFSET + escrita * FLASH_PAGE_SIZE,
+        .pagina = pg,
+        .apagar = escrita % PAGINAS_POR_SETOR == 0,     // Entrando no setor: o mais antigo se perde
+    };
+    if (flash_safe_execute(gravar_na_flash, &g, 100) == PICO_OK) {
+        escrita = (escrita + 1) % NUM_PAGINAS;
+        stats.paginas_gravadas++;
+    } else {
+        stats.paginas_perdidas++;
+    }
+
+    memset(pg, 0xFF, sizeof(*pg));          // Bytes não usados ficam apagados
+    pg->tam = 0;
+    xQueueSend(livres, &i, 0);
+}
+
+static uint32_t ler_varint(const uint8_t **p, const uint8_t *fim) {
+    uint32_t v = 0;
+    for (int s = 0; *p < fim; s += 7) {
+        uint8_t b = *(*p)++;
+        v |= (uint32_t)(b & 0x7F) << s;
+        if (!(b & 0x80))
+            break;
+    }
+    return v;
+}
+
+// Decodifica os registros de uma página válida
+static uint32_t ler_pagina(const pagina_t *pg, historico_cb_t cb, void *ctx) {
+    historico_registro_t r = { .boot = pg->boot, .t_ms = pg->t_ms };
+    const uint8_t *p = pg->dados, *fim = pg->dados + pg->tam;
+    uint32_t n = 0;
+    while (p < fim) {
+        r.tipo = *p++;
+        r.t_ms += ler_varint(&p, fim);
+        if (r.tipo == HISTORICO_AMOSTRA && p < fim && *p <= CANAIS_MAX) {
+            r.num_valores = *p++;
+            for (uint8_t i = 0; i < r.num_valores; i++) {
+                uint32_t z = ler_varint(&p, fim);
+                r.valores[i] += (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+            }
+        } else if (r.tipo == HISTORICO_ALARME && fim - p >= 2) {
+            r.alarme = *p++;
+            r.anterior = *p++;
+        } else {
+            break;                          // Tipo desconhecido: o resto da página é ilegível
+        }
+        cb(&r, ctx);
+        n++;
+    }
+    return n;
+}
+
+uint32_t historico_ler(historico_cb_t cb, void *ctx) {
+    uint32_t inicio = escrita, n = 0;
+    for (uint32_t k = 0; k < NUM_PAGINAS; k++) {
+        const pagina_t *pg = pagina_flash((inicio + k) % NUM_PAGINAS);
+        if (pagina_valida(pg))
+            n += ler_pagina(pg, cb, ctx);
+    }
+    return n;
+}
+
+historico_stats_t historico_stats(void) {
+    return stats;
+}
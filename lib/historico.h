@@ -0,0 +1,67 @@
+#ifndef HISTORICO_H
+#define HISTORICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "canais.h"
+
+// Histórico persistente das leituras e dos alarmes, em um log circular no fim da flash
+//
+// Os registros são codificados em deltas (varint/zigzag) por canal em uma página de 256
+// bytes na RAM; a página cheia vai para a tarefa gravadora, que apaga o setor
+// quando entra nele e programa a página. As páginas são escritas em sequência
+// pela região inteira, de modo que o desgaste é uniforme e o mais antigo é o
+// que se perde. Cada página tem número de sequência e CRC: na partida, a página
+// válida de maior sequência indica onde continuar, e uma página cortada por
+// falta de energia é ignorada.
+
+#ifndef HISTORICO_TAMANHO
+#define HISTORICO_TAMANHO (512 * 1024)      // Região no fim da flash (~1,8 h de leituras de 4 canais a 10 Hz)
+#endif
+#define HISTORICO_PAGINAS_RAM 8             // Páginas montadas/esperando gravação (RAM liberada pela redução do heap)
+#define HISTORICO_COMANDO 'h'               // Caractere recebido pela serial que pede o despejo
+
+typedef enum {
+    HISTORICO_AMOSTRA = 1,
+    HISTORICO_ALARME = 2,
+} historico_tipo_t;
+
+typedef struct {
+    historico_tipo_t tipo;
+    uint16_t boot;          // Partida em que o registro foi feito
+    uint32_t t_ms;          // Desde a partida
+    uint8_t num_valores;    // Amostra: valores dos canais, em décimos
+    int32_t valores[CANAIS_MAX];
+    uint8_t alarme;         // Alarme: nível novo e anterior
+    uint8_t anterior;
+} historico_registro_t;
+
+typedef struct {
+    uint32_t paginas_validas;
+    uint32_t paginas_gravadas;
+    uint32_t paginas_perdidas;      // Gravadora atrasada: página descartada na RAM
+    uint32_t varredura_us;          // Tempo da recuperação na partida
+    uint16_t boot;
+} historico_stats_t;
+
+// Procura o fim do log e prepara a próxima página. Antes do agendador
+bool historico_init(void);
+
+// Acrescenta registros à página atual (um único produtor, sem tocar na flash)
+void historico_amostra(uint64_t timestamp_us, const int32_t valores[], uint8_t num);
+void historico_alarme(uint64_t timestamp_us, uint8_t nivel, uint8_t anterior);
+
+// Entrega a página atual à gravadora mesmo incompleta (ex.: depois de um alarme)
+void historico_fechar_pagina(void);
+
+// Espera uma página cheia e a grava na flash; chamada em laço pela tarefa gravadora
+void historico_gravar(TickType_t espera);
+
+// Percorre os registros gravados, do mais antigo ao mais recente. Retorna quantos foram lidos
+typedef void (*historico_cb_t)(const historico_registro_t *r, void *ctx);
+uint32_t historico_ler(historico_cb_t cb, void *ctx);
+
+historico_stats_t historico_stats(void);
+
+#endif // HISTORICO_H
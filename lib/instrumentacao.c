@@ -0,0 +1,215 @@
+#include "instrumentacao.h"
+#include "latencia.h"
+#include "energia.h"
+#include "filtro.h"
+#include "previsao.h"
+#include "alarme.h"
+#include "hardware/dma.h"
+#include "hardware/structs/systick.h"
+#include "hardware/irq.h"
+#include "task.h"
+#include <stdio.h>
+
+// Formato do retrato, uma linha por registro:
+//   # instr,<t_us>,<nucleos>
+//   tarefa,<nome>,<cpu_por_mil>,<pilha_livre_bytes>,<ativacoes>
+//   fila,<nome>,<ocupacao>,<pico>,<capacidade>
+//   transf,<nome>,<n>,<media_us>,<max_us>
+//   lat,<sonda>,<n>,<max_us>,<histograma...>     (latencia.c)
+//   energia,<estado>,<ms>                          (energia.c)
+//   filtro,<leituras>,<ciclos_medios>,<ciclos_max> (filtro.c)
+//   previsao,<emitidas>,<confirmadas>,<descartadas>,<antecedencia_media_ms>,
+//            <antecedencia_min_ms>,<antecedencia_max_ms>,<ciclos_medios>,<ciclos_max> (previsao.c)
+//   alarme,<mudancas>
+//   # fim
+
+typedef struct {
+    bool monitorado;
+    uint canal;
+    volatile uint32_t inicio_us;
+    uint32_t n;
+    uint64_t soma_us;
+    uint32_t max_us;
+} transferencia_t;
+
+typedef struct {
+    const char *nome;
+    QueueHandle_t fila;
+    const spsc_ring_t *anel;
+    uint32_t pico;
+} fila_t;
+
+typedef struct {
+    TaskHandle_t tarefa;
+    uint32_t contador;
+    uint32_t ativacoes;
+} execucao_t;
+
+typedef struct {
+    const void *tcb;
+    uint32_t n;
+} ativacao_t;
+
+static transferencia_t transferencias[INSTR_NUM_TRANSFERENCIAS];
+static const char *const nomes_transf[INSTR_NUM_TRANSFERENCIAS] = { "i2c_display", "pio_matriz" };
+static bool irq_instalada = false;
+
+static fila_t filas[INSTR_MAX_FILAS];
+static uint num_filas = 0;
+
+// Contadores do retrato anterior, para a fatia de CPU do intervalo
+static TaskStatus_t estados[INSTR_MAX_TAREFAS];
+static execucao_t anteriores[INSTR_MAX_TAREFAS];
+static uint32_t total_anterior = 0;
+
+// Vezes que cada tarefa entrou em execução (traceTASK_SWITCHED_IN)
+static ativacao_t ativacoes[INSTR_MAX_TAREFAS];
+
+uint32_t instr_contador_us(void) {
+    return time_us_32();
+}
+
+uint32_t instr_ciclos(void) {
+    return systick_hw->cvr;
+}
+
+uint32_t instr_ciclos_desde(uint32_t inicio) {
+    uint32_t agora = systick_hw->cvr;
+    return agora <= inicio ? inicio - agora : inicio + systick_hw->rvr + 1 - agora;
+}
+
+static void instr_dma_irq(void) {
+    uint32_t agora = time_us_32();
+    for (int i = 0; i < INSTR_NUM_TRANSFERENCIAS; i++) {
+        transferencia_t *t = &transferencias[i];
+        if (!t->monitorado || !dma_channel_get_irq0_status(t->canal))
+            continue;
+        dma_channel_acknowledge_irq0(t->canal);
+        uint32_t us = agora - t->inicio_us;
+        t->n++;
+        t->soma_us += us;
+        if (us > t->max_us)
+            t->max_us = us;
+    }
+}
+
+// Chamada pelo escalonador a cada troca de contexto, com as travas do kernel
+// tomadas: só procura a tarefa na tabela e incrementa
+void instr_tarefa_ativada(const void *tcb) {
+    for (int i = 0; i < INSTR_MAX_TAREFAS; i++) {
+        if (ativacoes[i].tcb == tcb || ativacoes[i].tcb == NULL) {
+            ativacoes[i].tcb = tcb;
+            ativacoes[i].n++;
+            return;
+        }
+    }
+}
+
+void instr_monitorar_dma(instr_transferencia_t t, uint canal) {
+    transferencias[t].canal = canal;
+    transferencias[t].monitorado = true;
+    dma_channel_set_irq0_enabled(canal, true);
+    if (!irq_instalada) {
+        irq_add_shared_handler(DMA_IRQ_0, instr_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+        irq_instalada = true;
+    }
+}
+
+void instr_transferencia_inicio(instr_transferencia_t t) {
+    transferencias[t].inicio_us = time_us_32();
+}
+
+static void registrar(const char *nome, QueueHandle_t fila, const spsc_ring_t *anel) {
+    if (num_filas >= INSTR_MAX_FILAS)
+        return;
+    filas[num_filas++] = (fila_t){ .nome = nome, .fila = fila, .anel = anel };
+}
+
+void instr_registrar_fila(const char *nome, QueueHandle_t fila) {
+    registrar(nome, fila, NULL);
+}
+
+void instr_registrar_anel(const char *nome, const spsc_ring_t *anel) {
+    registrar(nome, NULL, anel);
+}
+
+static uint32_t ocupacao(const fila_t *f) {
+    return f->anel ? spsc_ring_count(f->anel) : uxQueueMessagesWaiting(f->fila);
+}
+
+static uint32_t capacidade(const fila_t *f) {
+    return f->anel ? f->anel->mascara + 1
+                   : uxQueueMessagesWaiting(f->fila) + uxQueueSpacesAvailable(f->fila);
+}
+
+void instr_amostrar(void) {
+    for (uint i = 0; i < num_filas; i++) {
+        uint32_t n = ocupacao(&filas[i]);
+        if (n > filas[i].pico)
+            filas[i].pico = n;
+    }
+}
+
+// Contadores da tarefa no retrato anterior (zerados se ela é nova)
+static execucao_t anterior(TaskHandle_t tarefa) {
+    for (int i = 0; i < INSTR_MAX_TAREFAS; i++)
+        if (anteriores[i].tarefa == tarefa)
+            return anteriores[i];
+    return (execucao_t){ tarefa, 0, 0 };
+}
+
+static uint32_t ativacoes_tarefa(TaskHandle_t tarefa) {
+    for (int i = 0; i < INSTR_MAX_TAREFAS; i++)
+        if (ativacoes[i].tcb == (const void *)tarefa)
+            return ativacoes[i].n;
+    return 0;
+}
+
+void instr_retrato_csv(void) {
+    uint32_t total;
+    UBaseType_t n = uxTaskGetSystemState(estados, INSTR_MAX_TAREFAS, &total);
+
+    // O contador é de 32 bits (~71 min): as diferenças continuam certas entre
+    // retratos pedidos em intervalos menores que isso
+    uint64_t intervalo = (uint64_t)(total - total_anterior) * ESTACAO_NUM_CORES;
+    total_anterior = total;
+
+    printf("# instr,%lu,%d\n", (unsigned long)time_us_32(), ESTACAO_NUM_CORES);
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t *e = &estados[i];
+        execucao_t a = anterior(e->xHandle);
+        uint32_t delta = e->ulRunTimeCounter - a.contador;
+        uint32_t por_mil = intervalo ? (uint32_t)((uint64_t)delta * 1000 / intervalo) : 0;
+        printf("tarefa,%s,%lu,%lu,%lu\n", e->pcTaskName, (unsigned long)por_mil,
+               (unsigned long)(e->usStackHighWaterMark * sizeof(StackType_t)),
+               (unsigned long)(ativacoes_tarefa(e->xHandle) - a.ativacoes));
+    }
+    for (UBaseType_t i = 0; i < INSTR_MAX_TAREFAS; i++) {
+        anteriores[i].tarefa = i < n ? estados[i].xHandle : NULL;
+        anteriores[i].contador = i < n ? estados[i].ulRunTimeCounter : 0;
+        anteriores[i].ativacoes = i < n ? ativacoes_tarefa(estados[i].xHandle) : 0;
+    }
+
+    instr_amostrar();
+    for (uint i = 0; i < num_filas; i++) {
+        const fila_t *f = &filas[i];
+        printf("fila,%s,%lu,%lu,%lu\n", f->nome, (unsigned long)ocupacao(f),
+               (unsigned long)f->pico, (unsigned long)capacidade(f));
+    }
+
+    for (int i = 0; i < INSTR_NUM_TRANSFERENCIAS; i++) {
+        const transferencia_t *t = &transferencias[i];
+        if (!t->monitorado)
+            continue;
+        printf("transf,%s,%lu,%lu,%lu\n", nomes_transf[i], (unsigned long)t->n,
+               (unsigned long)(t->n ? t->soma_us / t->n : 0), (unsigned long)t->max_us);
+    }
+
+    latencia_csv();
+    energia_csv();
+    filtro_csv();
+    previsao_csv();
+    printf("alarme,%lu\n", (unsigned long)alarme_mudancas());
+    printf("# fim\n");
+}
@@ -0,0 +1,50 @@
+#ifndef INSTRUMENTACAO_H
+#define INSTRUMENTACAO_H
+
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "spsc_ring.h"
+
+// Instrumentação do firmware em execução: fatia de CPU e número de ativações de
+// cada tarefa (contador de 1 MHz), mínimo de pilha livre, ocupação das filas, duração das
+// transferências de I2C/PIO e os histogramas de latência de latencia.c.
+// Nada é impresso sozinho: o retrato em CSV só sai na serial quando pedido.
+
+#define INSTR_MAX_TAREFAS 16
+#define INSTR_MAX_FILAS 8
+#define INSTR_COMANDO 's'           // Caractere recebido pela serial que pede um retrato
+
+typedef enum {
+    INSTR_I2C_DISPLAY,              // Envio de um quadro ao display (DMA -> FIFO do I2C)
+    INSTR_PIO_MATRIZ,               // Envio de um quadro à matriz (DMA -> FIFO da PIO)
+    INSTR_NUM_TRANSFERENCIAS
+} instr_transferencia_t;
+
+// Contador das estatísticas de execução do FreeRTOS (portGET_RUN_TIME_COUNTER_VALUE)
+uint32_t instr_contador_us(void);
+
+// Ciclos de CPU pelo SysTick (contagem regressiva no clk_sys, recarregada a cada
+// tick do FreeRTOS): mede trechos curtos, menores que um período do tick
+uint32_t instr_ciclos(void);
+uint32_t instr_ciclos_desde(uint32_t inicio);
+
+// Gancho traceTASK_SWITCHED_IN do FreeRTOS: conta as ativações de cada tarefa
+void instr_tarefa_ativada(const void *tcb);
+
+// Mede as transferências de um canal de DMA: do disparo (instr_transferencia_inicio)
+// até a interrupção de fim, na DMA_IRQ_0 compartilhada. Chamar no núcleo 0
+void instr_monitorar_dma(instr_transferencia_t t, uint canal);
+void instr_transferencia_inicio(instr_transferencia_t t);
+
+// Filas acompanhadas no retrato (ocupação atual e pico)
+void instr_registrar_fila(const char *nome, QueueHandle_t fila);
+void instr_registrar_anel(const char *nome, const spsc_ring_t *anel);
+
+// Atualiza o pico de ocupação das filas; chamar periodicamente
+void instr_amostrar(void);
+
+// Imprime o retrato em CSV. A fatia de CPU é a do intervalo desde o retrato anterior
+void instr_retrato_csv(void);
+
+#endif // INSTRUMENTACAO_H
@@ -0,0 +1,87 @@
+#include "latencia.h"
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint32_t medidas[LATENCIA_JANELA];  // Janela circular das últimas medidas (us)
+    uint32_t histograma[LATENCIA_FAIXAS];
+    uint32_t total;                     // Medidas desde o início
+    uint32_t maximo;
+} sonda_t;
+
+static sonda_t sondas[LATENCIA_NUM_SONDAS];
+static const char *const nomes[LATENCIA_NUM_SONDAS] = { "display", "matriz", "led", "buzzer" };
+
+void latencia_registrar(latencia_sonda_t sonda, uint64_t timestamp_amostra_us) {
+    sonda_t *s = &sondas[sonda];
+    uint64_t agora = time_us_64();
+    uint32_t us = agora > timestamp_amostra_us ? (uint32_t)(agora - timestamp_amostra_us) : 0;
+    s->medidas[s->total % LATENCIA_JANELA] = us;
+    uint32_t faixa = us ? 31 - __builtin_clz(us) : 0;
+    s->histograma[faixa < LATENCIA_FAIXAS ? faixa : LATENCIA_FAIXAS - 1]++;
+    s->total++;
+    if (us > s->maximo)
+        s->maximo = us;
+}
+
+static int comparar(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+void latencia_relatorio(void) {
+    static uint32_t ordenadas[LATENCIA_JANELA];
+    printf("latencia (%d nucleo(s)), us:\n", ESTACAO_NUM_CORES);
+    for (int i = 0; i < LATENCIA_NUM_SONDAS; i++) {
+        const sonda_t *s = &sondas[i];
+        uint32_t n = s->total < LATENCIA_JANELA ? s->total : LATENCIA_JANELA;
+        if (n == 0) {
+            printf("  %-8s sem medidas\n", nomes[i]);
+            continue;
+        }
+        memcpy(ordenadas, s->medidas, n * sizeof(uint32_t));
+        qsort(ordenadas, n, sizeof(uint32_t), comparar);
+        printf("  %-8s n=%lu p50=%lu p90=%lu p99=%lu max=%lu\n", nomes[i], (unsigned long)s->total,
+               (unsigned long)ordenadas[n * 50 / 100], (unsigned long)ordenadas[n * 90 / 100],
+               (unsigned long)ordenadas[n * 99 / 100], (unsigned long)s->maximo);
+    }
+}
+
+uint32_t latencia_percentil(latencia_sonda_t sonda, uint16_t por_mil) {
+    const sonda_t *s = &sondas[sonda];
+    uint32_t n = 0;
+    for (int k = 0; k < LATENCIA_FAIXAS; k++)
+        n += s->histograma[k];
+    if (n == 0)
+        return 0;
+
+    // Posição da medida procurada (1..n) e faixa que a contém
+    uint32_t posicao = (uint32_t)(((uint64_t)n * por_mil + 999) / 1000);
+    if (posicao == 0)
+        posicao = 1;
+    uint32_t antes = 0;
+    int k = 0;
+    while (k < LATENCIA_FAIXAS - 1 && antes + s->histograma[k] < posicao)
+        antes += s->histograma[k++];
+
+    // Faixa k = [2^k, 2^(k+1)) us, a 0 começando em 0; a última vai até o máximo
+    uint32_t inicio = k ? 1u << k : 0;
+    uint32_t fim = k < LATENCIA_FAIXAS - 1 ? 2u << k : s->maximo + 1;
+    uint32_t us = inicio + (uint32_t)((uint64_t)(fim - inicio) * (posicao - antes) / s->histograma[k]);
+    return us < s->maximo ? us : s->maximo;
+}
+
+void latencia_csv(void) {
+    for (int i = 0; i < LATENCIA_NUM_SONDAS; i++) {
+        const sonda_t *s = &sondas[i];
+        printf("lat,%s,%lu,%lu,%lu,%lu", nomes[i], (unsigned long)s->total,
+               (unsigned long)latencia_percentil(i, 500), (unsigned long)latencia_percentil(i, 990),
+               (unsigned long)s->maximo);
+        for (int k = 0; k < LATENCIA_FAIXAS; k++)
+            printf(",%lu", (unsigned long)s->histograma[k]);
+        printf("\n");
+    }
+}
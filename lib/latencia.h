@@ -0,0 +1,35 @@
+#ifndef LATENCIA_H
+#define LATENCIA_H
+
+#include <stdint.h>
+
+// Medição da latência entre o fim do bloco de amostras e a ação de cada atuador.
+// Sempre ativa: o histograma entra no retrato da instrumentação e os percentis
+// são impressos periodicamente no modo de benchmark (ESTACAO_BENCH_LATENCIA)
+
+typedef enum {
+    LATENCIA_DISPLAY,       // Envio do quadro iniciado
+    LATENCIA_MATRIZ,        // Quadro da matriz entregue à DMA
+    LATENCIA_LED,           // LED aceso
+    LATENCIA_BUZZER,        // Padrão sonoro pedido
+    LATENCIA_NUM_SONDAS
+} latencia_sonda_t;
+
+#define LATENCIA_JANELA 256     // Medidas mais recentes usadas nos percentis
+#define LATENCIA_FAIXAS 20      // Histograma em potências de 2: faixa k = [2^k, 2^(k+1)) us
+
+// Registra a latência de uma ação causada pela amostra de 'timestamp_amostra_us'.
+// Cada sonda deve ser usada por uma única tarefa
+void latencia_registrar(latencia_sonda_t sonda, uint64_t timestamp_amostra_us);
+
+// Imprime p50/p90/p99/máximo de cada sonda na serial
+void latencia_relatorio(void);
+
+// Percentil (em milésimos: 500 = p50) de todas as medidas da sonda desde a
+// partida, estimado pelo histograma com interpolação linear dentro da faixa
+uint32_t latencia_percentil(latencia_sonda_t sonda, uint16_t por_mil);
+
+// Imprime uma linha CSV por sonda: lat,<sonda>,<n>,<p50_us>,<p99_us>,<max_us>,<faixa 0>,...,<faixa 19>
+void latencia_csv(void);
+
+#endif // LATENCIA_H
@@ -1,78 +1,323 @@
 #include "led_matriz.h"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "pio_matriz.pio.h"
+#include "instrumentacao.h"
+#include "FreeRTOS.h"
+#include "timers.h"
+#include <string.h>
 
-Pixel desenho[NUM_PIXELS] = {0}; // Array global que representa a matriz de LEDs
+// Correção de gama (2,2) para a resposta do olho: gama_8[i] = 255 * (i / 255)^2,2
+static const uint8_t gama_8[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
 
-// Função para limpar todos os LEDs (preto)
-void limpar_todos_leds() {
-    for (int i = 0; i < NUM_PIXELS; i++) {
-        desenho[i].r = 0.0;
-        desenho[i].g = 0.0;
-        desenho[i].b = 0.0;
-    }
+// Gama e brilho combinados: converter um canal é uma única consulta
+static uint8_t tabela_cor[256];
+static bool tabela_pronta = false;
+
+static uint32_t cores[NUM_PIXELS];  // Cores pedidas (R << 16 | G << 8 | B), para recodificar ao mudar o brilho
+
+// Quadros com as palavras GRB na ordem de envio (o LED 24 é o primeiro da cadeia).
+// A DMA lê o quadro da frente enquanto os desenhos escrevem no de trás
+static Pixel quadros[2][NUM_PIXELS];
+static uint8_t frente = 0;
+
+static inline Pixel *quadro_tras(void) {
+    return quadros[frente ^ 1];
 }
 
-// Função para desenhar uma exclamação
-void exclamacao() {
-    limpar_todos_leds();
-    
-    // Padrão da exclamação (5x5) - vermelho
-    int exclama[] = {
-        0, 0, 1, 0, 0,
-        0, 0, 1, 0, 0,
-        0, 0, 1, 0, 0,
-        0, 0, 0, 0, 0,
-        0, 0, 1, 0, 0
-    };
+static PIO matriz_pio;
+static uint matriz_sm;
+static int matriz_dma = -1;
+static bool apresentado = false;    // O primeiro quadro é sempre enviado
+static const Pixel *exibido = quadros[0];   // Quadro na matriz: o da frente ou o de uma animação
 
-    for (int i = 0; i < NUM_PIXELS; i++) {
-        if (exclama[i]) {
-            set_pixel_color(i, 0.1, 0.0, 0.0); // Verde (R=0, G=0, B=0)
+// Paletas e quadros das animações (índice 0 da paleta é o fundo)
+#define ANIMACAO(nome, paleta, repetir, ...)                                    \
+    static const matriz_quadro_t quadros_##nome[] = { __VA_ARGS__ };            \
+    static Pixel grb_##nome[count_of(quadros_##nome)][NUM_PIXELS];              \
+    const matriz_anim_t nome = { quadros_##nome, count_of(quadros_##nome), paleta, repetir, grb_##nome }
+
+static const uint32_t paleta_verde[4] = { 0x000000, 0x00FF00 };
+static const uint32_t paleta_nivel[4] = { 0x000000, 0xFFB000, 0x400000 };  // Água e linha do limiar
+static const uint32_t paleta_vermelha[4] = { 0x000000, 0xFF0000 };
+static const uint32_t paleta_chuva[4] = { 0x000000, 0x0060FF, 0x001040 };   // Gota e rastro
+
+ANIMACAO(MATRIZ_CHECKMARK, paleta_verde, false,
+    { QUADRO(LINHA(0, 0, 0, 0, 0),
+             LINHA(0, 0, 0, 0, 1),
+             LINHA(0, 0, 0, 1, 0),
+             LINHA(1, 0, 1, 0, 0),
+             LINHA(0, 1, 0, 0, 0)), 0 },
+);
+
+ANIMACAO(MATRIZ_NIVEL, paleta_nivel, true,
+    { QUADRO(LINHA(0, 0, 0, 0, 0),
+             LINHA(2, 2, 2, 2, 2),
+             LINHA(0, 0, 0, 0, 0),
+             LINHA(0, 0, 0, 0, 0),
+             LINHA(1, 1, 1, 1, 1)), 300 },
+    { QUADRO(LINHA(0, 0, 0, 0, 0),
+             LINHA(2, 2, 2, 2, 2),
+             LINHA(0, 0, 0, 0, 0),
+             LINHA(1, 1, 1, 1, 1),
+             LINHA(1, 1, 1, 1, 1)), 300 },
+    { QUADRO(LINHA(0, 0, 0, 0, 0),
+             LINHA(2, 2, 2, 2, 2),
+             LINHA(1, 1, 1, 1, 1),
+             LINHA(1, 1, 1, 1, 1),
+             LINHA(1, 1, 1, 1, 1)), 600 },
+);
+
+ANIMACAO(MATRIZ_EXCLAMACAO, paleta_vermelha, true,
+    { QUADRO(LINHA(0, 0, 1, 0, 0),
+             LINHA(0, 0, 1, 0, 0),
+             LINHA(0, 0, 1, 0, 0),
+             LINHA(0, 0, 0, 0, 0),
+             LINHA(0, 0, 1, 0, 0)), 500 },
+    { 0, 250 },
+);
+
+ANIMACAO(MATRIZ_CRITICO, paleta_vermelha, true,
+    { QUADRO(LINHA(0, 0, 1, 0, 0),
+             LINHA(0, 0, 1, 0, 0),
+             LINHA(0, 0, 1, 0, 0),
+             LINHA(0, 0, 0, 0, 0),
+             LINHA(0, 0, 1, 0, 0)), 200 },
+    { QUADRO(LINHA(1, 1, 0, 1, 1),
+             LINHA(1, 1, 0, 1, 1),
+             LINHA(1, 1, 0, 1, 1),
+             LINHA(1, 1, 1, 1, 1),
+             LINHA(1, 1, 0, 1, 1)), 200 },
+);
+
+// Cada coluna com a sua fase: a gota desce uma linha por quadro, com um rastro
+ANIMACAO(MATRIZ_CHUVA, paleta_chuva, true,
+    { QUADRO(LINHA(1, 0, 2, 0, 0),
+             LINHA(0, 0, 1, 0, 2),
+             LINHA(0, 2, 0, 0, 1),
+             LINHA(0, 1, 0, 2, 0),
+             LINHA(2, 0, 0, 1, 0)), 120 },
+    { QUADRO(LINHA(2, 0, 0, 1, 0),
+             LINHA(1, 0, 2, 0, 0),
+             LINHA(0, 0, 1, 0, 2),
+             LINHA(0, 2, 0, 0, 1),
+             LINHA(0, 1, 0, 2, 0)), 120 },
+    { QUADRO(LINHA(0, 1, 0, 2, 0),
+             LINHA(2, 0, 0, 1, 0),
+             LINHA(1, 0, 2, 0, 0),
+             LINHA(0, 0, 1, 0, 2),
+             LINHA(0, 2, 0, 0, 1)), 120 },
+    { QUADRO(LINHA(0, 2, 0, 0, 1),
+             LINHA(0, 1, 0, 2, 0),
+             LINHA(2, 0, 0, 1, 0),
+             LINHA(1, 0, 2, 0, 0),
+             LINHA(0, 0, 1, 0, 2)), 120 },
+    { QUADRO(LINHA(0, 0, 1, 0, 2),
+             LINHA(0, 2, 0, 0, 1),
+             LINHA(0, 1, 0, 2, 0),
+             LINHA(2, 0, 0, 1, 0),
+             LINHA(1, 0, 2, 0, 0)), 120 },
+);
+
+static const matriz_quadro_t quadro_apagado[] = { { 0, 0 } };
+static Pixel grb_apagado[1][NUM_PIXELS];
+static const matriz_anim_t MATRIZ_APAGADA = { quadro_apagado, 1, paleta_verde, false, grb_apagado };
+
+static const matriz_anim_t *const animacoes[] = {
+    &MATRIZ_CHECKMARK, &MATRIZ_NIVEL, &MATRIZ_EXCLAMACAO, &MATRIZ_CRITICO, &MATRIZ_CHUVA, &MATRIZ_APAGADA,
+};
+
+static TimerHandle_t matriz_timer;
+static StaticTimer_t matriz_timer_estatico;
+
+// Pedido pendente, lido pelo temporizador no próximo quadro
+static const matriz_anim_t *volatile pedido = NULL;
+static const matriz_anim_t *escolhida = NULL;
+
+// Estado do sequenciador (só acessado pelo temporizador)
+static const matriz_anim_t *animacao = NULL;
+static uint8_t quadro = 0;
+
+static void codificar_animacoes(void);
+static void matriz_passo(TimerHandle_t timer);
+
+void matriz_init(PIO pio, uint pino) {
+    matriz_pio = pio;
+    matriz_sm = pio_claim_unused_sm(pio, true);
+    uint offset = pio_add_program(pio, &pio_matriz_program);
+    pio_matriz_program_init(pio, matriz_sm, offset, pino);
+
+    // Palavras de 32 bits para o FIFO TX, no ritmo do DREQ da máquina de estados
+    matriz_dma = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(matriz_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, matriz_sm, true));
+    dma_channel_configure(matriz_dma, &c, &pio->txf[matriz_sm], quadros[frente], 0, false);
+    instr_monitorar_dma(INSTR_PIO_MATRIZ, matriz_dma);
+
+    // Temporizador de um disparo: cada quadro o rearma com a sua duração
+    codificar_animacoes();
+    matriz_timer = xTimerCreateStatic("Matriz", 1, pdFALSE, NULL, matriz_passo, &matriz_timer_estatico);
+}
+
+void matriz_aguardar(void) {
+    if (matriz_dma >= 0)
+        dma_channel_wait_for_finish_blocking(matriz_dma);
+}
+
+bool matriz_apresentar(void) {
+    if (apresentado && memcmp(quadro_tras(), exibido, sizeof(quadros[0])) == 0)
+        return false;               // Nada mudou: a matriz mantém o último quadro
+
+    // Um envio leva ~750 us; com as atualizações a cada 50 ms a espera quase nunca acontece
+    matriz_aguardar();
+    frente ^= 1;
+    exibido = quadros[frente];
+    apresentado = true;
+    instr_transferencia_inicio(INSTR_PIO_MATRIZ);
+    dma_channel_transfer_from_buffer_now(matriz_dma, quadros[frente], NUM_PIXELS);
+
+    // O novo quadro de trás parte do que está na matriz
+    memcpy(quadro_tras(), quadros[frente], sizeof(quadros[0]));
+    return true;
+}
+
+bool matriz_apresentar_quadro(const Pixel *q) {
+    if (apresentado && q == exibido)
+        return false;
+
+    // Os quadros mais curtos duram 120 ms: a espera pelo envio anterior não acontece
+    matriz_aguardar();
+    exibido = q;
+    apresentado = true;
+    instr_transferencia_inicio(INSTR_PIO_MATRIZ);
+    dma_channel_transfer_from_buffer_now(matriz_dma, q, NUM_PIXELS);
+    return true;
+}
+
+static void montar_tabela(uint8_t brilho) {
+    for (int i = 0; i < 256; i++)
+        tabela_cor[i] = (uint8_t)((gama_8[i] * (brilho + 1u)) >> 8);
+    tabela_pronta = true;
+}
+
+void matriz_set_brilho(uint8_t brilho) {
+    montar_tabela(brilho);
+    for (int i = 0; i < NUM_PIXELS; i++)
+        set_pixel_color(i, cores[i] >> 16, cores[i] >> 8, cores[i]);
+
+    // A DMA pode estar lendo um quadro das animações: recodifica depois do envio
+    matriz_aguardar();
+    codificar_animacoes();
+    apresentado = false;
+    if (escolhida)
+        matriz_animar(escolhida);   // Reapresenta a animação com o novo brilho
+}
+
+// Converte os bitmaps em palavras GRB na ordem de envio. As linhas ímpares
+// percorrem a cadeia no sentido contrário (serpentina), e o LED 24 é o primeiro
+static void codificar_animacoes(void) {
+    for (size_t a = 0; a < count_of(animacoes); a++) {
+        const matriz_anim_t *anim = animacoes[a];
+        for (uint8_t q = 0; q < anim->num_quadros; q++) {
+            uint64_t bits = anim->quadros[q].pixels;
+            for (int i = 0; i < NUM_PIXELS; i++, bits >>= 2) {
+                int linha = i / 5, coluna = i % 5;
+                int led = linha * 5 + (linha & 1 ? 4 - coluna : coluna);
+                uint32_t rgb = anim->paleta[bits & 3];
+                anim->codificados[q][NUM_PIXELS - 1 - led] = matrix_rgb(rgb >> 16, rgb >> 8, rgb);
+            }
         }
     }
 }
 
-// Função para desenhar um V de OK
-void checkmark() {
-    limpar_todos_leds();
-    
-    // Padrão do V (5x5) - verde
-    int checkmark[] = {
-        0, 0, 0, 0, 0,
-        1, 0, 0, 0, 0,
-        0, 0, 0, 1, 0,
-        0, 0, 1, 0, 1,
-        0, 1, 0, 0, 0
+uint16_t matriz_sequenciar(void) {
+    taskENTER_CRITICAL();
+    const matriz_anim_t *novo = pedido;
+    pedido = NULL;
+    taskEXIT_CRITICAL();
+
+    if (novo) {
+        animacao = novo;
+        quadro = 0;
+    } else if (!animacao || (quadro + 1 >= animacao->num_quadros && !animacao->repetir)) {
+        return 0;
+    } else if (++quadro >= animacao->num_quadros) {
+        quadro = 0;
+    }
+
+    matriz_apresentar_quadro(animacao->codificados[quadro]);
+    if (quadro + 1 >= animacao->num_quadros && !animacao->repetir)
+        return 0;                   // Último quadro fica na matriz sem rearmar o temporizador
+    return animacao->quadros[quadro].dur_ms;
+}
+
+static void matriz_passo(TimerHandle_t timer) {
+    uint16_t ms = matriz_sequenciar();
+    if (ms)
+        xTimerChangePeriod(timer, pdMS_TO_TICKS(ms), 0);
+}
+
+void matriz_animar(const matriz_anim_t *anim) {
+    escolhida = anim;
+    taskENTER_CRITICAL();
+    pedido = anim ? anim : &MATRIZ_APAGADA;
+    taskEXIT_CRITICAL();
+    if (matriz_timer)
+        xTimerChangePeriod(matriz_timer, 1, 0);     // Dispara no próximo tick; não espera a fila de comandos
+}
+
+const matriz_anim_t *matriz_severidade(uint8_t nivel, uint8_t previsto) {
+    static const matriz_anim_t *const por_nivel[] = {
+        &MATRIZ_CHECKMARK, &MATRIZ_NIVEL, &MATRIZ_EXCLAMACAO, &MATRIZ_CRITICO,
     };
+    if (nivel >= count_of(por_nivel))
+        nivel = count_of(por_nivel) - 1;
+    const matriz_anim_t *anim = previsto > nivel ? &MATRIZ_CHUVA : por_nivel[nivel];
+    if (anim != escolhida)
+        matriz_animar(anim);
+    return anim;
+}
 
+// Função para limpar todos os LEDs (preto)
+void limpar_todos_leds() {
     for (int i = 0; i < NUM_PIXELS; i++) {
-        if (checkmark[i]) {
-            set_pixel_color(i, 0.0, 0.1, 0.0); // Verde (R=0, G=0, B=0)
-        }
+        cores[i] = 0;
+        quadro_tras()[i] = 0;
     }
 }
 
-// Função existente para definir a cor de um LED específico
-void set_pixel_color(int led_index, double r, double g, double b) {
+// Define a cor de um LED; a palavra GRB é calculada aqui, uma vez por mudança de desenho
+void set_pixel_color(int led_index, uint8_t r, uint8_t g, uint8_t b) {
     if (led_index >= 0 && led_index < NUM_PIXELS) {
-        desenho[led_index].r = r;
-        desenho[led_index].g = g;
-        desenho[led_index].b = b;
+        cores[led_index] = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+        quadro_tras()[NUM_PIXELS - 1 - led_index] = matrix_rgb(r, g, b);
     }
 }
 
-// Função existente para converter RGB em valor de 32 bits (formato GRB)
-uint32_t matrix_rgb(double b, double r, double g) {
-    return ((uint32_t)(g * 255) << 24) | ((uint32_t)(r * 255) << 16) | (uint32_t)(b * 255) << 8;
+// Converte RGB em valor de 32 bits (formato GRB) usando só inteiros: o RP2040 não tem FPU
+Pixel matrix_rgb(uint8_t r, uint8_t g, uint8_t b) {
+    if (!tabela_pronta)
+        montar_tabela(MATRIZ_BRILHO_PADRAO);
+    return ((uint32_t)tabela_cor[g] << 24) | ((uint32_t)tabela_cor[r] << 16) | ((uint32_t)tabela_cor[b] << 8);
 }
-
-// Função existente para enviar os dados para a matriz de LEDs
-void desenho_pio(uint32_t valor_led, PIO pio, uint sm) {
-    for (int16_t i = 0; i < NUM_PIXELS; i++) {
-        valor_led = matrix_rgb(
-            desenho[24-i].b,  // azul
-            desenho[24-i].r,  // vermelho
-            desenho[24-i].g   // verde
-        );
-        pio_sm_put_blocking(pio, sm, valor_led);
-    }
-}
\ No newline at end of file
@@ -2,24 +2,81 @@
 #define LED_MATRIZ_H
 
 #include "hardware/pio.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 #define pino_matriz 7
 #define NUM_PIXELS 25
 
-typedef struct {
-    double r;
-    double g;
-    double b;
-} Pixel;
+#define MATRIZ_BRILHO_PADRAO 26     // ~10% do máximo, mesmo nível dos desenhos originais
+
+// Cor de um LED já codificada para o PIO: G << 24 | R << 16 | B << 8
+// (o programa desloca 24 bits para a esquerda, a partir do bit 31)
+typedef uint32_t Pixel;
+
+// Converte RGB (0-255) na palavra GRB, aplicando gama e o brilho global
+Pixel matrix_rgb(uint8_t r, uint8_t g, uint8_t b);
+void set_pixel_color(int led_index, uint8_t r, uint8_t g, uint8_t b);
+
+// Brilho global (0-255). Recodifica o desenho atual e os quadros das animações com o novo brilho
+void matriz_set_brilho(uint8_t brilho);
 
-// Protótipos das funções existentes
-uint32_t matrix_rgb(double b, double r, double g);
-void desenho_pio(uint32_t valor_led, PIO pio, uint sm);
-void set_pixel_color(int led_index, double r, double g, double b);
+// Driver: o desenho é feito no quadro de trás e enviado pela DMA ao FIFO da PIO
+void matriz_init(PIO pio, uint pino);   // Carrega o programa PIO e reserva a máquina de estados e a DMA
+bool matriz_apresentar(void);           // Envia o quadro de trás se ele mudou; não bloqueia
+void matriz_aguardar(void);             // Espera o fim do envio em andamento
 
-// Novas funções para desenhar símbolos
+// Envia um quadro já codificado (palavras GRB na ordem de envio) direto da sua
+// memória, sem cópia. O quadro deve permanecer válido até o próximo envio
+bool matriz_apresentar_quadro(const Pixel *quadro);
+
+// Desenho livre no quadro de trás, enviado com matriz_apresentar()
 void limpar_todos_leds();         // Limpa todos os LED's
-void exclamacao();                 // Liga os LED's em forma de exclamação
-void checkmark();                 // Liga os LED's em forma de V para dar OK
 
-#endif // LED_MATRIZ_H
\ No newline at end of file
+// Animações
+//
+// Os quadros ficam na flash como bitmaps de 2 bits por LED, desenhados como
+// aparecem na matriz (linha 0 em cima), com uma paleta de 4 cores por animação.
+// matriz_init converte todos de uma vez em palavras GRB na ordem da cadeia
+// (serpentina, gama e brilho), e a reprodução só entrega esses quadros à DMA.
+// Um temporizador do FreeRTOS troca os quadros; animações de um só quadro não
+// repetem e deixam o temporizador parado.
+
+#define LINHA(a, b, c, d, e) ((a) | (b) << 2 | (c) << 4 | (d) << 6 | (e) << 8)
+#define QUADRO(l0, l1, l2, l3, l4) \
+    ((uint64_t)(l0) | (uint64_t)(l1) << 10 | (uint64_t)(l2) << 20 | (uint64_t)(l3) << 30 | (uint64_t)(l4) << 40)
+
+typedef struct {
+    uint64_t pixels;            // QUADRO(LINHA(...), ...): índice da cor de cada LED
+    uint16_t dur_ms;
+} matriz_quadro_t;
+
+typedef struct {
+    const matriz_quadro_t *quadros;
+    uint8_t num_quadros;
+    const uint32_t *paleta;     // 4 cores RGB (0xRRGGBB), pelo índice do bitmap
+    bool repetir;               // Volta ao primeiro quadro ao terminar
+    Pixel (*codificados)[NUM_PIXELS];   // Quadros em GRB, preenchidos por matriz_init
+} matriz_anim_t;
+
+// Animações prontas
+extern const matriz_anim_t MATRIZ_CHECKMARK;     // V verde fixo: níveis normais
+extern const matriz_anim_t MATRIZ_NIVEL;         // Barra amarela subindo até a linha do limiar
+extern const matriz_anim_t MATRIZ_EXCLAMACAO;    // Exclamação vermelha piscando
+extern const matriz_anim_t MATRIZ_CRITICO;       // Exclamação alternando com a matriz vermelha invertida
+extern const matriz_anim_t MATRIZ_CHUVA;         // Gotas azuis caindo: limiar previsto
+
+// Troca a animação em execução (NULL apaga). Só registra o pedido e retorna:
+// o temporizador apresenta o primeiro quadro no tick seguinte
+void matriz_animar(const matriz_anim_t *anim);
+
+// Escolhe a animação pelo evento do avaliador: a previsão acima do nível atual
+// mostra a chuva, senão cada severidade tem a sua. Repetir a mesma escolha não
+// reinicia a animação. Retorna a animação escolhida
+const matriz_anim_t *matriz_severidade(uint8_t nivel, uint8_t previsto);
+
+// Apresenta o quadro seguinte da animação pedida e retorna os ms até o próximo
+// (0: parada). Chamada pelo temporizador; o benchmark a chama diretamente
+uint16_t matriz_sequenciar(void);
+
+#endif // LED_MATRIZ_H
@@ -0,0 +1,187 @@
+#include "previsao.h"
+#include "instrumentacao.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    const previsao_config_t *cfg;
+    // Janela circular: leituras e instantes (ms); 'proxima' é onde entra a nova
+    int32_t y[PREVISAO_JANELA_MAX];
+    uint32_t t_ms[PREVISAO_JANELA_MAX];
+    uint8_t n, proxima;
+    // Somas da regressão com x = posição na janela (0 = leitura mais antiga)
+    int64_t soma_y, soma_xy;
+    alarme_nivel_t alvo;        // Nível seguinte do canal na última leitura
+    bool ativo;                 // Prevendo 'alvo' (com histerese no horizonte)
+} estado_previsao_t;
+
+static estado_previsao_t estados[PREVISAO_MAX_CANAIS];
+static previsao_stats_t stats;
+static uint32_t leituras;
+static uint64_t ciclos_total;
+static uint64_t antecedencia_total_ms;
+
+// Previsão em andamento, para medir a antecedência quando o alarme se confirma
+static alarme_nivel_t pendente = ALARME_NORMAL;
+static uint64_t pendente_desde_us;
+
+void previsao_init(uint8_t canal, const previsao_config_t *cfg) {
+    if (canal >= PREVISAO_MAX_CANAIS)
+        return;
+    memset(&estados[canal], 0, sizeof(estados[canal]));
+    estados[canal].cfg = cfg;
+}
+
+static uint8_t tamanho_janela(const estado_previsao_t *e) {
+    return e->cfg->janela > PREVISAO_JANELA_MAX ? PREVISAO_JANELA_MAX : e->cfg->janela;
+}
+
+// Entra a leitura nova e, com a janela cheia, sai a mais antiga. Ao sair a
+// mais antiga (x = 0) as demais descem uma posição: soma_xy perde uma vez a
+// soma das que ficaram
+static void acrescentar(estado_previsao_t *e, uint8_t janela, int32_t y, uint32_t t_ms) {
+    if (e->n >= 2) {
+        uint8_t ultima = (e->proxima + janela - 1) % janela;
+        uint8_t antiga = e->n == janela ? e->proxima : 0;
+        uint32_t intervalo = (e->t_ms[ultima] - e->t_ms[antiga]) / (e->n - 1);
+        uint32_t d = t_ms - e->t_ms[ultima];
+        if (d * 2 < intervalo || d > intervalo * 2) {
+            e->n = 0;                               // Mudou a taxa das leituras: recomeça
+            e->proxima = 0;
+            e->soma_y = e->soma_xy = 0;
+        }
+    }
+    if (e->n == janela) {
+        e->soma_y -= e->y[e->proxima];
+        e->soma_xy -= e->soma_y;
+        e->n--;
+    }
+    e->soma_xy += (int64_t)e->n * y;
+    e->soma_y += y;
+    e->y[e->proxima] = y;
+    e->t_ms[e->proxima] = t_ms;
+    e->proxima = (e->proxima + 1) % janela;
+    e->n++;
+}
+
+// Milissegundos até a reta da regressão chegar ao limiar, ou -1 se ela não sobe.
+// Com n leituras, inclinação = num / den leituras, com
+//   num = n * Sxy - Sx * Sy,  den = n * Sxx - Sx^2 = n^2 (n^2 - 1) / 12,
+// e o valor ajustado na leitura mais nova é Sy / n + inclinação * (n - 1) / 2
+static int64_t tempo_ate(const estado_previsao_t *e, uint8_t janela, int32_t limiar) {
+    int64_t n = e->n;
+    int64_t den = n * n * (n * n - 1) / 12;
+    int64_t num = n * e->soma_xy - n * (n - 1) / 2 * e->soma_y;
+    int64_t ajustado = (2 * den * e->soma_y + num * n * (n - 1)) / (2 * n * den);
+    if (ajustado >= limiar)
+        return 0;
+    if (num <= 0)
+        return -1;
+
+    int64_t falta = limiar - ajustado;
+    if (falta > (1 << 24))
+        falta = 1 << 24;                            // Muito além de qualquer horizonte
+    int64_t leituras_q8 = falta * den * 256 / num;
+    if (leituras_q8 > ((int64_t)1 << 40))
+        leituras_q8 = (int64_t)1 << 40;
+    uint8_t antiga = e->proxima;                    // Janela cheia: a mais antiga é a próxima a sair
+    uint8_t ultima = (e->proxima + janela - 1) % janela;
+    uint32_t duracao_ms = e->t_ms[ultima] - e->t_ms[antiga];
+    return leituras_q8 * duracao_ms / ((n - 1) * 256);
+}
+
+// Atualiza a previsão do canal; retorna os segundos até o nível seguinte ou -1
+static int32_t prever_canal(uint8_t canal, estado_previsao_t *e, int32_t y, uint32_t t_ms) {
+    uint8_t janela = tamanho_janela(e);
+    acrescentar(e, janela, y, t_ms);
+
+    alarme_nivel_t alvo = alarme_nivel_canal(canal) + 1;
+    if (alvo != e->alvo) {
+        e->alvo = alvo;
+        e->ativo = false;
+    }
+    int32_t limiar = alarme_limiar(canal, alvo);
+    if (e->n < janela || limiar == INT32_MAX) {
+        e->ativo = false;
+        return -1;
+    }
+
+    int64_t ms = tempo_ate(e, janela, limiar);
+    uint32_t horizonte_ms = e->cfg->horizonte_s * 1000u;
+    if (ms < 0 || ms > horizonte_ms + horizonte_ms / 4)
+        e->ativo = false;
+    else if (ms <= horizonte_ms)
+        e->ativo = true;
+    return e->ativo ? (int32_t)((ms + 999) / 1000) : -1;
+}
+
+static void medir_antecedencia(uint64_t timestamp_us) {
+    uint32_t ms = (uint32_t)((timestamp_us - pendente_desde_us) / 1000);
+    antecedencia_total_ms += ms;
+    if (stats.confirmadas == 0 || ms < stats.antecedencia_min_ms)
+        stats.antecedencia_min_ms = ms;
+    if (ms > stats.antecedencia_max_ms)
+        stats.antecedencia_max_ms = ms;
+    stats.confirmadas++;
+}
+
+previsao_t previsao_atualizar(const int32_t valores[], uint8_t num, uint64_t timestamp_us) {
+    uint32_t inicio = instr_ciclos();
+    uint32_t t_ms = (uint32_t)(timestamp_us / 1000);
+    alarme_nivel_t geral = alarme_nivel_atual();
+    previsao_t p = { ALARME_NORMAL, 0, 0 };
+    if (num > PREVISAO_MAX_CANAIS)
+        num = PREVISAO_MAX_CANAIS;
+
+    // O alarme previsto se confirmou nesta leitura (alarme_avaliar já rodou)
+    if (pendente != ALARME_NORMAL && geral >= pendente) {
+        medir_antecedencia(timestamp_us);
+        pendente = ALARME_NORMAL;
+    }
+
+    for (uint8_t i = 0; i < num; i++) {
+        estado_previsao_t *e = &estados[i];
+        if (e->cfg == NULL || e->cfg->janela < 2)
+            continue;
+        int32_t s = prever_canal(i, e, valores[i], t_ms);
+        if (s < 0 || e->alvo <= geral)
+            continue;
+        if (p.nivel == ALARME_NORMAL || s < p.segundos) {
+            p.nivel = e->alvo;
+            p.canal = i;
+            p.segundos = s > UINT16_MAX ? UINT16_MAX : (uint16_t)s;
+        }
+    }
+
+    if (p.nivel != ALARME_NORMAL) {
+        if (pendente == ALARME_NORMAL) {
+            stats.emitidas++;
+            pendente_desde_us = timestamp_us;
+        }
+        pendente = p.nivel;
+    } else if (pendente != ALARME_NORMAL) {
+        stats.descartadas++;
+        pendente = ALARME_NORMAL;
+    }
+
+    uint32_t ciclos = instr_ciclos_desde(inicio);
+    ciclos_total += ciclos;
+    leituras++;
+    if (ciclos > stats.ciclos_max)
+        stats.ciclos_max = ciclos;
+    return p;
+}
+
+previsao_stats_t previsao_stats(void) {
+    previsao_stats_t s = stats;
+    s.antecedencia_media_ms = s.confirmadas ? (uint32_t)(antecedencia_total_ms / s.confirmadas) : 0;
+    s.ciclos_medios = leituras ? (uint32_t)(ciclos_total / leituras) : 0;
+    return s;
+}
+
+void previsao_csv(void) {
+    previsao_stats_t s = previsao_stats();
+    printf("previsao,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", (unsigned long)s.emitidas, (unsigned long)s.confirmadas,
+           (unsigned long)s.descartadas, (unsigned long)s.antecedencia_media_ms, (unsigned long)s.antecedencia_min_ms,
+           (unsigned long)s.antecedencia_max_ms, (unsigned long)s.ciclos_medios, (unsigned long)s.ciclos_max);
+}
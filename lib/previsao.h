@@ -0,0 +1,61 @@
+#ifndef PREVISAO_H
+#define PREVISAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "alarme.h"
+
+// Previsão de cruzamento de limiar por regressão linear
+//
+// Cada canal configurado ajusta uma reta de mínimos quadrados às últimas
+// 'janela' leituras filtradas. As somas da regressão são atualizadas a cada
+// leitura (sai a mais antiga, entra a nova), com custo constante e só inteiros.
+// Extrapolando a reta até o limiar do nível seguinte do canal, obtém-se o
+// tempo até o cruzamento; abaixo de 'horizonte_s' o canal passa a prever esse
+// nível, e deixa de prever quando o tempo passa de 5/4 do horizonte ou a
+// tendência para de subir. A previsão mais próxima vai ao avaliador de alarmes
+// (alarme_prever), que a entrega às saídas.
+//
+// A regressão supõe leituras igualmente espaçadas: se o intervalo entre elas
+// muda (entrada ou saída da economia), a janela recomeça.
+
+#define PREVISAO_MAX_CANAIS 6
+#define PREVISAO_JANELA_MAX 64          // Leituras máximas na janela da regressão
+
+typedef struct {
+    uint8_t janela;         // Leituras na regressão (menos de 2 desliga)
+    uint16_t horizonte_s;   // Antecedência máxima de uma previsão
+} previsao_config_t;
+
+typedef struct {
+    alarme_nivel_t nivel;   // Nível previsto (ALARME_NORMAL: nenhum)
+    uint8_t canal;
+    uint16_t segundos;      // Até o limiar do nível previsto (0: já no limiar)
+} previsao_t;
+
+typedef struct {
+    uint32_t emitidas;              // Previsões iniciadas
+    uint32_t confirmadas;           // O nível geral chegou ao previsto
+    uint32_t descartadas;           // A previsão acabou antes do nível ser atingido
+    uint32_t antecedencia_media_ms; // Do início da previsão até a confirmação do alarme
+    uint32_t antecedencia_min_ms;
+    uint32_t antecedencia_max_ms;
+    uint32_t ciclos_medios;         // Ciclos de CPU por leitura (todos os canais)
+    uint32_t ciclos_max;
+} previsao_stats_t;
+
+// Configura a regressão de um canal e zera o estado (não copia: deve permanecer válida)
+void previsao_init(uint8_t canal, const previsao_config_t *cfg);
+
+// Atualiza as regressões com uma leitura filtrada de todos os canais e retorna a
+// previsão mais próxima acima do nível geral. Chamar depois de alarme_avaliar,
+// pela mesma tarefa
+previsao_t previsao_atualizar(const int32_t valores[], uint8_t num, uint64_t timestamp_us);
+
+previsao_stats_t previsao_stats(void);
+
+// Linha do retrato da instrumentação: previsao,<emitidas>,<confirmadas>,<descartadas>,
+// <antecedencia_media_ms>,<antecedencia_min_ms>,<antecedencia_max_ms>,<ciclos_medios>,<ciclos_max>
+void previsao_csv(void);
+
+#endif // PREVISAO_H
@@ -0,0 +1,93 @@
+#include "sensor_bus.h"
+
+// Barramento publish/subscribe: cada assinante tem sua própria fila, de modo
+// que uma única publicação é vista por todos os consumidores
+
+static sensor_bus_sub_t assinantes[SENSOR_BUS_MAX_SUBSCRIBERS];
+static uint8_t num_assinantes = 0;
+static uint32_t proxima_seq = 0;
+
+// Espaço das filas e anéis, repartido entre os assinantes na ordem de registro
+static sensor_amostra_t reserva[SENSOR_BUS_RESERVA];
+static uint16_t reserva_usada = 0;
+
+// Registra um novo assinante - deve ser chamada antes de iniciar o agendador
+sensor_bus_sub_t *sensor_bus_subscribe(sensor_bus_mode_t modo, UBaseType_t profundidade) {
+    if (num_assinantes >= SENSOR_BUS_MAX_SUBSCRIBERS)
+        return NULL;
+
+    if (modo == SENSOR_BUS_MAILBOX || profundidade == 0)
+        profundidade = 1;   // Caixa de correio: apenas o último valor
+
+    UBaseType_t capacidade = profundidade;
+    if (modo == SENSOR_BUS_RING) {
+        capacidade = 1;
+        while (capacidade < profundidade)
+            capacidade <<= 1;               // O anel exige potência de 2
+    }
+    if (reserva_usada + capacidade > SENSOR_BUS_RESERVA)
+        return NULL;
+    sensor_amostra_t *buf = &reserva[reserva_usada];
+
+    sensor_bus_sub_t *sub = &assinantes[num_assinantes];
+    if (modo == SENSOR_BUS_RING) {
+        spsc_ring_init(&sub->anel, buf, sizeof(sensor_amostra_t), capacidade);
+        sub->fila = NULL;
+        sub->consumidor = NULL;
+    } else {
+        sub->fila = xQueueCreateStatic(capacidade, sizeof(sensor_amostra_t), (uint8_t *)buf, &sub->fila_estatica);
+        if (sub->fila == NULL)
+            return NULL;
+    }
+    reserva_usada += capacidade;
+    sub->modo = modo;
+    sub->descartadas = 0;
+    num_assinantes++;
+    return sub;
+}
+
+// Publica uma amostra para todos os assinantes sem bloquear o produtor
+void sensor_bus_publish(sensor_amostra_t *amostra) {
+    amostra->seq = proxima_seq++;
+
+    for (uint8_t i = 0; i < num_assinantes; i++) {
+        sensor_bus_sub_t *sub = &assinantes[i];
+        if (sub->modo == SENSOR_BUS_RING) {
+            if (!spsc_ring_push(&sub->anel, amostra))
+                sub->descartadas++;
+            // Escrita da cabeça antes da leitura do consumidor: par da barreira em sensor_bus_receive
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            TaskHandle_t consumidor = __atomic_load_n(&sub->consumidor, __ATOMIC_ACQUIRE);
+            if (consumidor != NULL)
+                xTaskNotifyGive(consumidor);        // Acorda o consumidor, mesmo em outro núcleo
+        } else if (sub->modo == SENSOR_BUS_MAILBOX) {
+            xQueueOverwrite(sub->fila, amostra);    // Substitui o valor anterior
+        } else if (xQueueSend(sub->fila, amostra, 0) != pdTRUE) {
+            sensor_amostra_t antiga;                // Fila cheia: descarta a mais antiga
+            xQueueReceive(sub->fila, &antiga, 0);
+            xQueueSend(sub->fila, amostra, 0);
+            sub->descartadas++;
+        }
+    }
+}
+
+// Recebe a próxima amostra do assinante, aguardando até 'espera' ticks.
+// No modo anel a espera usa a notificação da tarefa: a primeira chamada registra
+// a tarefa consumidora, que deve ser sempre a mesma
+bool sensor_bus_receive(sensor_bus_sub_t *sub, sensor_amostra_t *amostra, TickType_t espera) {
+    if (sub->modo != SENSOR_BUS_RING)
+        return xQueueReceive(sub->fila, amostra, espera) == pdTRUE;
+
+    // Registro seguido da leitura do anel: sem a barreira (store->load), o produtor
+    // poderia não ver o registro e esta tarefa não ver a amostra, e o despertar se
+    // perderia até o fim da espera
+    if (sub->consumidor == NULL) {
+        __atomic_store_n(&sub->consumidor, xTaskGetCurrentTaskHandle(), __ATOMIC_RELEASE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+    while (!spsc_ring_pop(&sub->anel, amostra)) {
+        if (ulTaskNotifyTake(pdTRUE, espera) == 0)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+#ifndef SENSOR_BUS_H
+#define SENSOR_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+#include "spsc_ring.h"
+#include "canais.h"
+
+#define SENSOR_BUS_MAX_SUBSCRIBERS 8    // Número máximo de tarefas consumidoras
+#define SENSOR_BUS_RESERVA 32           // Amostras reservadas para as filas de todos os assinantes
+
+typedef struct // Amostra publicada pela tarefa da aquisição
+{
+    int32_t valores[CANAIS_MAX];        // Décimos da unidade, filtrados, na ordem da tabela de canais
+    int32_t tendencias[CANAIS_MAX];     // Décimos por minuto (filtro.h)
+    uint32_t seq;                       // Número de sequência da amostra
+    uint64_t timestamp_us;              // Instante da leitura (time_us_64)
+} sensor_amostra_t;
+
+typedef enum {
+    SENSOR_BUS_MAILBOX,                 // Guarda apenas a amostra mais recente
+    SENSOR_BUS_HISTORY,                 // Guarda as últimas N amostras, descartando a mais antiga
+    SENSOR_BUS_RING                     // Fila sem travas para consumidor em outro núcleo; descarta a nova se cheia
+} sensor_bus_mode_t;
+
+typedef struct {
+    QueueHandle_t fila;
+    StaticQueue_t fila_estatica;
+    spsc_ring_t anel;                   // Modo SENSOR_BUS_RING
+    TaskHandle_t consumidor;            // Tarefa avisada a cada publicação (modo anel)
+    sensor_bus_mode_t modo;
+    uint32_t descartadas;               // Amostras perdidas por fila cheia (modos histórico e anel)
+} sensor_bus_sub_t;
+
+sensor_bus_sub_t *sensor_bus_subscribe(sensor_bus_mode_t modo, UBaseType_t profundidade);
+void sensor_bus_publish(sensor_amostra_t *amostra);
+bool sensor_bus_receive(sensor_bus_sub_t *sub, sensor_amostra_t *amostra, TickType_t espera);
+
+#endif // SENSOR_BUS_H
@@ -0,0 +1,40 @@
+#include "spsc_ring.h"
+#include <string.h>
+
+// Cargas e escritas de 32 bits alinhadas são atômicas no Cortex-M0+; as ordens
+// acquire/release geram as barreiras (DMB) que publicam o elemento antes do índice
+
+bool spsc_ring_init(spsc_ring_t *r, void *buf, uint16_t tam_elem, uint32_t capacidade) {
+    if (capacidade == 0 || (capacidade & (capacidade - 1)) != 0)
+        return false;
+    r->buf = buf;
+    r->tam_elem = tam_elem;
+    r->mascara = capacidade - 1;
+    r->cabeca = 0;
+    r->cauda = 0;
+    return true;
+}
+
+bool spsc_ring_push(spsc_ring_t *r, const void *elem) {
+    uint32_t cabeca = r->cabeca;
+    uint32_t cauda = __atomic_load_n(&r->cauda, __ATOMIC_ACQUIRE);
+    if (cabeca - cauda > r->mascara)
+        return false;
+    memcpy(r->buf + (cabeca & r->mascara) * r->tam_elem, elem, r->tam_elem);
+    __atomic_store_n(&r->cabeca, cabeca + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool spsc_ring_pop(spsc_ring_t *r, void *elem) {
+    uint32_t cauda = r->cauda;
+    uint32_t cabeca = __atomic_load_n(&r->cabeca, __ATOMIC_ACQUIRE);
+    if (cabeca == cauda)
+        return false;
+    memcpy(elem, r->buf + (cauda & r->mascara) * r->tam_elem, r->tam_elem);
+    __atomic_store_n(&r->cauda, cauda + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint32_t spsc_ring_count(const spsc_ring_t *r) {
+    return __atomic_load_n(&r->cabeca, __ATOMIC_ACQUIRE) - __atomic_load_n(&r->cauda, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,27 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Fila circular sem travas para exatamente um produtor e um consumidor, que
+// podem estar em núcleos diferentes. O produtor só escreve 'cabeca' e o
+// consumidor só escreve 'cauda'; os índices crescem livremente e a posição é
+// obtida com a máscara da capacidade (potência de 2).
+
+typedef struct {
+    uint8_t *buf;
+    uint16_t tam_elem;
+    uint32_t mascara;           // capacidade - 1
+    uint32_t cabeca;            // Próxima posição a escrever (produtor)
+    uint32_t cauda;             // Próxima posição a ler (consumidor)
+} spsc_ring_t;
+
+// 'capacidade' deve ser potência de 2; 'buf' precisa de capacidade * tam_elem bytes
+bool spsc_ring_init(spsc_ring_t *r, void *buf, uint16_t tam_elem, uint32_t capacidade);
+
+bool spsc_ring_push(spsc_ring_t *r, const void *elem);     // false se cheia (só o produtor chama)
+bool spsc_ring_pop(spsc_ring_t *r, void *elem);            // false se vazia (só o consumidor chama)
+uint32_t spsc_ring_count(const spsc_ring_t *r);
+
+#endif // SPSC_RING_H
@@ -1,17 +1,35 @@
 #include "ssd1306.h"
-#include "font.h"
+#include "font_atlas.h"   // Gerado em tempo de compilação a partir de font.h
+#include "instrumentacao.h"
 #include <string.h>
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
-  ssd->width = width;
-  ssd->height = height;
-  ssd->pages = height / 8U;
+  ssd->width = width < SSD1306_MAX_WIDTH ? width : SSD1306_MAX_WIDTH;
+  ssd->height = height < SSD1306_MAX_PAGES * 8 ? height : SSD1306_MAX_PAGES * 8;
+  ssd->pages = ssd->height / 8U;
   ssd->address = address;
   ssd->i2c_port = i2c;
   ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  memset(ssd->ram_buffer, 0, ssd->bufsize);
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+
+  // Estado do envio parcial: a primeira transferência manda o quadro inteiro
+  memset(ssd->sent_buffer, 0, ssd->bufsize);
+  ssd1306_mark_dirty(ssd, 0, 0, ssd->width - 1, ssd->height - 1);
+  ssd->force_full = true;
+  ssd->bytes_sent = 0;
+
+  // Canal DMA que alimenta o FIFO de transmissão do I2C. Cada página alterada
+  // ocupa uma transação de comando (7 bytes) e uma de dados (1 + largura)
+  ssd->dma_chan = dma_claim_unused_channel(true);
+  dma_channel_config c = dma_channel_get_default_config(ssd->dma_chan);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+  dma_channel_configure(ssd->dma_chan, &c, &i2c_get_hw(i2c)->data_cmd, ssd->dma_words, 0, false);
+  instr_monitorar_dma(INSTR_I2C_DISPLAY, ssd->dma_chan);
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
@@ -43,6 +61,7 @@ void ssd1306_config(ssd1306_t *ssd) {
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  ssd1306_wait(ssd);
   ssd->port_buffer[1] = command;
   i2c_write_blocking(
     ssd->i2c_port,
@@ -53,66 +72,218 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   );
 }
 
+// Liga ou desliga o painel (modo de espera do controlador); a RAM do display
+// é mantida, então ao religar ele mostra o último quadro enviado
+void ssd1306_power(ssd1306_t *ssd, bool on) {
+  ssd1306_command(ssd, SET_DISP | (on ? 0x01 : 0x00));
+}
+
+// Marca como alterado o retângulo (x0, y0)-(x1, y1), já limitado à tela
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+  if (x0 >= ssd->width || y0 >= ssd->height)
+    return;
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  if (y1 >= ssd->height)
+    y1 = ssd->height - 1;
+  for (uint8_t page = y0 >> 3; page <= (y1 >> 3); ++page) {
+    if (x0 < ssd->dirty_x0[page])
+      ssd->dirty_x0[page] = x0;
+    if (x1 > ssd->dirty_x1[page])
+      ssd->dirty_x1[page] = x1;
+  }
+}
+
+// Reduz a faixa suja da página às colunas que realmente diferem do display,
+// atualiza a cópia enviada e limpa a marcação. Retorna false se nada mudou
+static bool ssd1306_take_window(ssd1306_t *ssd, uint8_t page, uint8_t *x0, uint8_t *x1) {
+  uint8_t a = ssd->dirty_x0[page];
+  uint8_t b = ssd->dirty_x1[page];
+  ssd->dirty_x0[page] = 0xFF;
+  ssd->dirty_x1[page] = 0;
+  if (a > b)
+    return false;
+
+  const uint8_t *novo = ssd->ram_buffer + 1 + page;
+  uint8_t *antigo = ssd->sent_buffer + 1 + page;
+  if (!ssd->force_full) {
+    while (a <= b && novo[a * ssd->pages] == antigo[a * ssd->pages])
+      a++;
+    if (a > b)
+      return false;
+    while (novo[b * ssd->pages] == antigo[b * ssd->pages])
+      b--;
+  }
+  for (uint8_t x = a; x <= b; ++x)
+    antigo[x * ssd->pages] = novo[x * ssd->pages];
+
+  *x0 = a;
+  *x1 = b;
+  return true;
+}
+
+// Envia apenas as páginas alteradas, bloqueando até o fim da transferência
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  uint8_t dados[1 + 255];
+  ssd1306_wait(ssd);
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    uint8_t x0, x1;
+    if (!ssd1306_take_window(ssd, page, &x0, &x1))
+      continue;
+
+    // Janela de endereçamento restrita à página e às colunas alteradas
+    uint8_t cmd[7] = {0x00, SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, page, page};
+    i2c_write_blocking(ssd->i2c_port, ssd->address, cmd, sizeof(cmd), false);
+
+    uint16_t n = 0;
+    dados[n++] = 0x40;
+    for (uint8_t x = x0; x <= x1; ++x)
+      dados[n++] = ssd->ram_buffer[1 + x * ssd->pages + page];
+    i2c_write_blocking(ssd->i2c_port, ssd->address, dados, n, false);
+    ssd->bytes_sent += sizeof(cmd) + n;
+  }
+  ssd->force_full = false;
+}
+
+// Monta as transações das páginas alteradas e entrega ao DMA, retornando em seguida.
+// O quadro é copiado para o buffer do DMA, então o ram_buffer pode ser redesenhado
+// enquanto a transferência anterior ainda está em andamento
+void ssd1306_send_data_async(ssd1306_t *ssd) {
+  uint16_t *w = ssd->dma_words;
+  ssd1306_wait(ssd);
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    uint8_t x0, x1;
+    if (!ssd1306_take_window(ssd, page, &x0, &x1))
+      continue;
+
+    const uint8_t cmd[7] = {0x00, SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, page, page};
+    for (uint8_t i = 0; i < sizeof(cmd); ++i)
+      *w++ = cmd[i];
+    w[-1] |= I2C_IC_DATA_CMD_STOP_BITS;     // STOP encerra a transação de comando
+
+    *w++ = 0x40;
+    for (uint8_t x = x0; x <= x1; ++x)
+      *w++ = ssd->ram_buffer[1 + x * ssd->pages + page];
+    w[-1] |= I2C_IC_DATA_CMD_STOP_BITS;
+  }
+  ssd->force_full = false;
+
+  uint32_t n = w - ssd->dma_words;
+  if (n == 0)
+    return;   // Nada mudou desde o último envio
+  ssd->bytes_sent += n;
+
+  // Mesmo procedimento do i2c_write_blocking para selecionar o endereço do escravo
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  hw->enable = 0;
+  hw->tar = ssd->address;
+  hw->enable = 1;
+  instr_transferencia_inicio(INSTR_I2C_DISPLAY);
+  dma_channel_transfer_from_buffer_now(ssd->dma_chan, ssd->dma_words, n);
+}
+
+// Indica se ainda há uma transferência em andamento (DMA ou FIFO do I2C)
+bool ssd1306_busy(ssd1306_t *ssd) {
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  return dma_channel_is_busy(ssd->dma_chan) ||
+         !(hw->status & I2C_IC_STATUS_TFE_BITS) ||
+         (hw->status & I2C_IC_STATUS_ACTIVITY_BITS);
+}
+
+// Aguarda o fim da transferência assíncrona
+void ssd1306_wait(ssd1306_t *ssd) {
+  while (ssd1306_busy(ssd))
+    tight_loop_contents();
+
+  // Em caso de NACK o controlador descarta o FIFO: o display fica em estado
+  // desconhecido e o próximo envio deve ser completo
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  if (hw->tx_abrt_source) {
+    (void) hw->clr_tx_abrt;
+    ssd1306_mark_dirty(ssd, 0, 0, ssd->width - 1, ssd->height - 1);
+    ssd->force_full = true;
+  }
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height)
+    return;
   uint16_t index = (y >> 3) + (x << 3) + 1;
   uint8_t pixel = (y & 0b111);
+  uint8_t page = y >> 3;
+  if (x < ssd->dirty_x0[page])
+    ssd->dirty_x0[page] = x;
+  if (x > ssd->dirty_x1[page])
+    ssd->dirty_x1[page] = x;
   if (value)
     ssd->ram_buffer[index] |= (1 << pixel);
   else
     ssd->ram_buffer[index] &= ~(1 << pixel);
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+// Preenche o retângulo [x0, x1] x [y0, y1] (já recortado) trabalhando com bytes
+// inteiros de página: cada coluna ocupa 'pages' bytes consecutivos no ram_buffer
+static void ssd1306_fill_span(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y0, uint8_t y1, bool value) {
+  uint8_t p0 = y0 >> 3;
+  uint8_t p1 = y1 >> 3;
+  uint8_t mask[SSD1306_MAX_PAGES];
+  for (uint8_t p = p0; p <= p1; ++p)
+    mask[p] = 0xFF;
+  mask[p0] &= 0xFF << (y0 & 7);
+  mask[p1] &= 0xFF >> (7 - (y1 & 7));
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
+  for (uint8_t x = x0; ; ++x) {
+    uint8_t *col = ssd->ram_buffer + 1 + x * ssd->pages;
+    for (uint8_t p = p0; p <= p1; ++p) {
+      if (value)
+        col[p] |= mask[p];
+      else
+        col[p] &= ~mask[p];
     }
+    if (x == x1)
+      break;
+  }
+  ssd1306_mark_dirty(ssd, x0, y0, x1, y1);
 }
 
+// Recorta o retângulo à tela; retorna false se ficou vazio
+static bool ssd1306_clip(ssd1306_t *ssd, int *x0, int *y0, int *x1, int *y1) {
+  if (*x0 > *x1) { int t = *x0; *x0 = *x1; *x1 = t; }
+  if (*y0 > *y1) { int t = *y0; *y0 = *y1; *y1 = t; }
+  if (*x1 < 0 || *y1 < 0 || *x0 >= ssd->width || *y0 >= ssd->height)
+    return false;
+  if (*x0 < 0) *x0 = 0;
+  if (*y0 < 0) *y0 = 0;
+  if (*x1 >= ssd->width) *x1 = ssd->width - 1;
+  if (*y1 >= ssd->height) *y1 = ssd->height - 1;
+  return true;
+}
 
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
+  ssd1306_mark_dirty(ssd, 0, 0, ssd->width - 1, ssd->height - 1);
+}
 
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
-  }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
-  }
+  if (width == 0 || height == 0)
+    return;
+  int x0 = left, y0 = top, x1 = left + width - 1, y1 = top + height - 1;
+  if (!ssd1306_clip(ssd, &x0, &y0, &x1, &y1))
+    return;
 
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    ssd1306_fill_span(ssd, x0, x1, y0, y1, value);
+    return;
   }
+  // Contorno: só desenha as bordas que não foram cortadas pelo recorte
+  if (top == y0)
+    ssd1306_fill_span(ssd, x0, x1, y0, y0, value);
+  if (top + height - 1 == y1)
+    ssd1306_fill_span(ssd, x0, x1, y1, y1, value);
+  if (left == x0)
+    ssd1306_fill_span(ssd, x0, x0, y0, y1, value);
+  if (left + width - 1 == x1)
+    ssd1306_fill_span(ssd, x1, x1, y0, y1, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
@@ -145,40 +316,64 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  int a = x0, b = x1, y0 = y, y1 = y;
+  if (ssd1306_clip(ssd, &a, &y0, &b, &y1))
+    ssd1306_fill_span(ssd, a, b, y0, y1, value);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  int x0 = x, x1 = x, a = y0, b = y1;
+  if (ssd1306_clip(ssd, &x0, &a, &x1, &b))
+    ssd1306_fill_span(ssd, x0, x1, a, b, value);
 }
 
-// Função para desenhar um caractere no display
+// Desloca as colunas (x0, x1] das páginas [page0, page1] uma posição para a
+// esquerda, descartando a coluna x0. A coluna x1 mantém o conteúdo anterior e
+// deve ser redesenhada pelo chamador. Usado pelos gráficos que rolam
+void ssd1306_shift_left(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  if (page1 >= ssd->pages)
+    page1 = ssd->pages - 1;
+  if (x0 >= x1 || page0 > page1)
+    return;
+  uint8_t *dst = ssd->ram_buffer + 1 + x0 * ssd->pages;
+  for (uint8_t x = x0; x < x1; ++x, dst += ssd->pages)
+    memcpy(dst + page0, dst + ssd->pages + page0, page1 - page0 + 1);
+  ssd1306_mark_dirty(ssd, x0, page0 * 8, x1, page1 * 8 + 7);
+}
+
+// Função para desenhar um caractere no display: o atlas já está em colunas,
+// então cada glifo são 8 bytes copiados direto para as páginas
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y) {
-  uint8_t index = (uint8_t)c;  // Obtém o índice do caractere
-  if(index == 135) {
-    index = 127;
+  ssd1306_blit_columns(ssd, font_cols[font_index[(uint8_t)c]], 8, x, y);
+}
+
+// Copia 'n' bytes de coluna (bit 0 = linha de cima) para a posição (x, y).
+// Com y múltiplo de 8 cada coluna é um único byte; caso contrário ela se divide
+// entre duas páginas. Os pixels apagados da coluna também são escritos
+void ssd1306_blit_columns(ssd1306_t *ssd, const uint8_t *cols, uint8_t n, uint8_t x, uint8_t y) {
+  if (n == 0 || x >= ssd->width || y >= ssd->height)
+    return;  // Sem colunas (ex.: glifo vazio): x + n - 1 marcaria a linha de páginas inteira
+  if (n > ssd->width - x)
+    n = ssd->width - x;
+
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 7;
+  uint8_t *dst = ssd->ram_buffer + 1 + x * ssd->pages + page;
+  if (shift == 0) {
+    for (uint8_t i = 0; i < n; ++i, dst += ssd->pages)
+      *dst = cols[i];
   } else {
-    if(index >= 129){
-      index = 0;
+    uint8_t keep_lo = 0xFF >> (8 - shift);  // Linhas acima do glifo na primeira página
+    bool has_next = page + 1 < ssd->pages;
+    for (uint8_t i = 0; i < n; ++i, dst += ssd->pages) {
+      dst[0] = (dst[0] & keep_lo) | (uint8_t)(cols[i] << shift);
+      if (has_next)
+        dst[1] = (dst[1] & ~keep_lo) | (cols[i] >> (8 - shift));
     }
   }
-  
-  const uint8_t *char_data = font[index];  // Obtém os dados do caractere a partir da fonte
-
-  // Desenha cada linha do caractere
-  for (uint8_t i = 0; i < 8; i++) {
-      uint8_t line = char_data[i];  // Linha atual do caractere
-      for (uint8_t j = 0; j < 8; j++) {
-          if (line & 0x01) {  // Verifica o bit mais à direita
-              ssd1306_pixel(ssd, x + j, y + i, 1);  // Desenha o pixel
-          } else {
-              ssd1306_pixel(ssd, x + j, y + i, 0);  // Apaga o pixel
-          }
-          line >>= 1;  // Desloca para o próximo bit
-      }
-  }
+  ssd1306_mark_dirty(ssd, x, y, x + n - 1, y + 7);
 }
 
 // Função para desenhar uma string
@@ -188,18 +383,58 @@ void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
   {
     ssd1306_draw_char(ssd, *str++, x, y);
     x += 8;
-    if (x + 8 >= ssd->width)
+    if (x + 8 > ssd->width)     // Próximo caractere não cabe: continua na linha de baixo
     {
       x = 0;
       y += 8;
     }
-    if (y + 8 >= ssd->height)
+    if (y + 8 > ssd->height)
     {
       break;
     }
   }
 }
 
+// Desenha uma string com largura proporcional (cada glifo ocupa só as colunas
+// usadas, mais uma coluna de espaçamento). Retorna a posição x final
+uint8_t ssd1306_draw_string_prop(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y) {
+  static const uint8_t espaco = 0x00;
+  while (*str && x < ssd->width) {
+    uint8_t g = font_index[(uint8_t)*str++];
+    ssd1306_blit_columns(ssd, font_cols[g] + font_offset[g], font_width[g], x, y);
+    x += font_width[g];
+    ssd1306_blit_columns(ssd, &espaco, 1, x, y);
+    x += 1;
+  }
+  return x;
+}
+
+// Desenha uma string proporcional ampliada 2x (16 pixels de altura), usada nos alertas
+uint8_t ssd1306_draw_string_2x(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y) {
+  static const uint8_t espaco[2] = {0x00, 0x00};
+  while (*str && x < ssd->width) {
+    uint8_t g = font_index[(uint8_t)*str++];
+    uint8_t ini = font_offset[g] * 2;
+    uint8_t larg = font_width[g] * 2;
+    ssd1306_blit_columns(ssd, font_cols_2x[g][0] + ini, larg, x, y);
+    ssd1306_blit_columns(ssd, font_cols_2x[g][1] + ini, larg, x, y + 8);
+    x += larg;
+    ssd1306_blit_columns(ssd, espaco, 2, x, y);
+    ssd1306_blit_columns(ssd, espaco, 2, x, y + 8);
+    x += 2;
+  }
+  return x;
+}
+
+// Largura em pixels de uma string proporcional (escala 1 ou 2)
+uint8_t ssd1306_string_width(const char *str, uint8_t escala) {
+  uint16_t largura = 0;
+  while (*str)
+    largura += font_width[font_index[(uint8_t)*str++]] + 1;
+  largura *= escala;
+  return largura > 255 ? 255 : largura;
+}
+
 // Função para centralizar o texto no display de 128x64 pixels
 int centralizar_texto(const char *str) {
   int largura_texto = strlen(str) * 8;  // Cada caractere ocupa 8 pixels de largura
@@ -1,9 +1,16 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
 
 #define WIDTH 128
 #define HEIGHT 64
+#define SSD1306_MAX_PAGES 8
+#define SSD1306_MAX_WIDTH 128
+#define SSD1306_BUFSIZE (1 + SSD1306_MAX_PAGES * SSD1306_MAX_WIDTH)
 
 typedef enum {
   SET_CONTRAST = 0x81,
@@ -29,15 +36,27 @@ typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t *i2c_port;
   bool external_vcc;
-  uint8_t *ram_buffer;
+  uint8_t ram_buffer[SSD1306_BUFSIZE];    // Buffers estáticos, dimensionados para o maior display
   size_t bufsize;
   uint8_t port_buffer[2];
+  uint8_t sent_buffer[SSD1306_BUFSIZE];   // Cópia do que já está na GDDRAM do display
+  uint8_t dirty_x0[SSD1306_MAX_PAGES];    // Faixa de colunas alteradas por página (x0 > x1 = limpa)
+  uint8_t dirty_x1[SSD1306_MAX_PAGES];
+  bool force_full;                        // Ignora a comparação e envia tudo (conteúdo do display desconhecido)
+  int dma_chan;
+  uint16_t dma_words[SSD1306_MAX_PAGES * (8 + SSD1306_MAX_WIDTH)];   // Sequência de comandos para o registrador IC_DATA_CMD
+  uint32_t bytes_sent;                    // Total de bytes enviados pelo barramento I2C
 } ssd1306_t;
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+void ssd1306_power(ssd1306_t *ssd, bool on);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_send_data_async(ssd1306_t *ssd);
+bool ssd1306_busy(ssd1306_t *ssd);
+void ssd1306_wait(ssd1306_t *ssd);
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -45,6 +64,13 @@ void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
+void ssd1306_shift_left(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1);
+void ssd1306_blit_columns(ssd1306_t *ssd, const uint8_t *cols, uint8_t n, uint8_t x, uint8_t y);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
-int centralizar_texto(const char *str);
\ No newline at end of file
+uint8_t ssd1306_draw_string_prop(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+uint8_t ssd1306_draw_string_2x(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+uint8_t ssd1306_string_width(const char *str, uint8_t escala);
+int centralizar_texto(const char *str);
+
+#endif // SSD1306_H
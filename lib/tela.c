@@ -0,0 +1,94 @@
+#include "tela.h"
+#include "ui.h"
+#include "alarme.h"
+#include "canais.h"
+#include <stdio.h>
+
+static ui_tela_t tela;
+static ui_serie_t serie;
+static ui_widget_t *faixa, *grafico;
+static ui_widget_t *rotulos[TELA_LINHAS], *numeros[TELA_LINHAS], *unidades[TELA_LINHAS];
+static int32_t soma[UI_GRAFICO_SERIES];
+static uint8_t acumuladas;
+static uint8_t num_grupos;
+
+// Widgets retidos: os rótulos só são redesenhados quando o grupo de canais
+// muda e os demais quando o valor muda (ui.c). O gráfico rola uma coluna
+// por ponto novo e mostra os dois primeiros canais na escala de cada um
+void tela_init(ssd1306_t *ssd) {
+    num_grupos = (canais_num() + TELA_LINHAS - 1) / TELA_LINHAS;
+    ssd1306_fill(ssd, false);
+    ui_init(&tela, ssd);
+    faixa = ui_faixa(&tela, 0, 0, WIDTH, 24);
+    grafico = ui_grafico(&tela, 0, 24, WIDTH, 24, 1000, &serie);    // Canal 0 pontilhado, canal 1 contínuo
+    for (uint8_t l = 0; l < TELA_LINHAS; l++) {
+        rotulos[l] = ui_rotulo(&tela, 0, 48 + 8 * l, "");
+        numeros[l] = ui_numero(&tela, 72, 48 + 8 * l, 3);
+        unidades[l] = ui_rotulo(&tela, 96, 48 + 8 * l, "");
+    }
+}
+
+// Textos da faixa superior do display conforme o nível de alarme. Com uma
+// previsão, o detalhe conta os segundos até o limiar do nível previsto
+static void atualizar_faixa(alarme_nivel_t nivel) {
+    uint16_t segundos;
+    alarme_nivel_t previsto = alarme_previsao(&segundos);
+    if (previsto > nivel) {
+        static const char *const nomes[ALARME_NUM_NIVEIS] = { "", "Aviso", "Alerta", "Critico" };
+        char detalhe[UI_MAX_TEXTO + 1];
+        snprintf(detalhe, sizeof(detalhe), "%s em %us", nomes[previsto], segundos);
+        ui_set_faixa(faixa, nivel >= ALARME_ALERTA ? "ALERTA!" : "ATENCAO", detalhe);
+    } else if (nivel >= ALARME_ALERTA) {
+        ui_set_faixa(faixa, "ALERTA!", nivel == ALARME_CRITICO ? "NIVEL CRITICO" : "NIVEIS ANORMAIS"); // Texto de alerta ampliado
+    } else if (nivel == ALARME_AVISO) {
+        ui_set_faixa(faixa, NULL, "Niveis elevados");
+    } else {
+        ui_set_faixa(faixa, NULL, "Niveis normais");
+    }
+}
+
+// Grupo de canais mostrado abaixo do gráfico: o do canal mais grave quando há
+// alarme, senão os grupos se alternam
+static uint8_t grupo_da_tela(uint64_t agora_us) {
+    alarme_evento_t ev;
+    alarme_ultimo_evento(&ev);
+    uint8_t pior = 0;
+    for (uint8_t i = 1; i < canais_num(); i++)
+        if (ev.niveis[i] > ev.niveis[pior])
+            pior = i;
+    if (ev.niveis[pior] > ALARME_NORMAL)
+        return pior / TELA_LINHAS;
+    return (agora_us / TELA_TROCA_US) % num_grupos;
+}
+
+void tela_atualizar(const sensor_amostra_t *amostra) {
+    uint8_t n = canais_num();
+
+    // Cada linha mostra um canal do grupo, em unidades inteiras
+    uint8_t grupo = grupo_da_tela(amostra->timestamp_us);
+    for (uint8_t l = 0; l < TELA_LINHAS; l++) {
+        uint8_t i = (grupo * TELA_LINHAS + l) % n;
+        const canal_t *c = canais_canal(i);
+        int32_t v = amostra->valores[i];
+        ui_set_texto(rotulos[l], c->rotulo);
+        ui_set_valor(numeros[l], (v + (v < 0 ? -5 : 5)) / 10);
+        ui_set_texto(unidades[l], c->unidade);
+    }
+
+    for (uint8_t k = 0; k < UI_GRAFICO_SERIES && k < n; k++)
+        soma[k] += amostra->valores[k];
+    if (++acumuladas == TELA_GRAFICO_DECIMACAO) {       // Um ponto do gráfico é a média de várias leituras
+        uint16_t ponto[UI_GRAFICO_SERIES] = {0, 0};
+        for (uint8_t k = 0; k < UI_GRAFICO_SERIES && k < n; k++) {
+            ponto[k] = canais_proporcao(k, soma[k] / acumuladas, 1000);
+            soma[k] = 0;
+        }
+        ui_grafico_adicionar(grafico, ponto);
+        acumuladas = 0;
+    }
+    atualizar_faixa(alarme_nivel_atual());
+}
+
+bool tela_desenhar(void) {
+    return ui_desenhar(&tela);
+}
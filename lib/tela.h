@@ -0,0 +1,27 @@
+#ifndef TELA_H
+#define TELA_H
+
+#include <stdbool.h>
+#include "ssd1306.h"
+#include "sensor_bus.h"
+
+// Composição da tela da estação sobre os widgets de ui.h
+//
+// Faixa de alerta no topo, gráfico de tendência dos dois primeiros canais e,
+// abaixo dele, TELA_LINHAS canais por vez (rótulo, valor inteiro e unidade).
+// Usada pela tarefa do display e pelo benchmark da simulação nativa.
+
+#define TELA_LINHAS 2               // Canais mostrados de cada vez abaixo do gráfico
+#define TELA_TROCA_US 3000000       // Com mais canais que linhas, alterna os grupos a cada 3 s
+#define TELA_GRAFICO_DECIMACAO 5    // Leituras por ponto do gráfico (128 pontos a 2 Hz: ~1 min)
+
+// Limpa o ram_buffer e cria os widgets. Depois de canais_init
+void tela_init(ssd1306_t *ssd);
+
+// Leva uma amostra e o estado dos alarmes aos widgets, sem desenhar
+void tela_atualizar(const sensor_amostra_t *amostra);
+
+// Rasteriza os widgets alterados no ram_buffer. Retorna true se algo foi desenhado
+bool tela_desenhar(void);
+
+#endif // TELA_H
@@ -0,0 +1,58 @@
+#include "telemetria.h"
+#include "spsc_ring.h"
+#include "pico/stdlib.h"
+#include <string.h>
+
+#define TELEMETRIA_LOTE 8           // Quadros agrupados em uma escrita na serial
+
+static spsc_ring_t anel;
+static enq_registro_t registros[TELEMETRIA_CAPACIDADE];
+static TaskHandle_t escritor = NULL;
+static uint16_t proxima_seq = 0;
+static telemetria_stats_t stats;
+
+bool telemetria_init(void) {
+    return spsc_ring_init(&anel, registros, sizeof(enq_registro_t), TELEMETRIA_CAPACIDADE);
+}
+
+bool telemetria_enviar(enq_tipo_t tipo, uint32_t t_us, const void *dados, uint8_t tam) {
+    enq_registro_t r = { .tipo = tipo, .seq = proxima_seq++, .t_us = t_us };
+    r.tam = tam < ENQ_MAX_DADOS ? tam : ENQ_MAX_DADOS;
+    memcpy(r.dados, dados, r.tam);
+    if (!spsc_ring_push(&anel, &r)) {
+        stats.descartados++;
+        return false;
+    }
+    TaskHandle_t t = __atomic_load_n(&escritor, __ATOMIC_ACQUIRE);
+    if (t != NULL)
+        xTaskNotifyGive(t);
+    return true;
+}
+
+void telemetria_escrever(TickType_t espera) {
+    if (escritor == NULL)
+        __atomic_store_n(&escritor, xTaskGetCurrentTaskHandle(), __ATOMIC_RELEASE);
+
+    static uint8_t lote[TELEMETRIA_LOTE * ENQ_MAX_QUADRO];
+    enq_registro_t r;
+    if (spsc_ring_count(&anel) == 0)
+        ulTaskNotifyTake(pdTRUE, espera);
+
+    size_t len = 0;
+    uint32_t n = 0;
+    while (spsc_ring_pop(&anel, &r)) {
+        len += enq_codificar(&r, &lote[len]);
+        n++;
+        if (n % TELEMETRIA_LOTE == 0) {
+            stdio_put_string((const char *)lote, (int)len, false, false);   // Binário: sem CRLF
+            len = 0;
+        }
+    }
+    if (len)
+        stdio_put_string((const char *)lote, (int)len, false, false);
+    stats.enviados += n;
+}
+
+telemetria_stats_t telemetria_stats(void) {
+    return stats;
+}
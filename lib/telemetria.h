@@ -0,0 +1,35 @@
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "enquadramento.h"
+
+// Telemetria binária pela serial (USB CDC)
+//
+// O produtor só copia um registro para uma fila sem travas e avisa a tarefa
+// escritora, que codifica os quadros (enquadramento.h) e os envia sem conversão
+// de fim de linha. tools/telemetria_decode.c converte o fluxo de volta em CSV.
+
+#define TELEMETRIA_CAPACIDADE 32    // Registros na fila (potência de 2)
+
+typedef struct {
+    uint32_t enviados;
+    uint32_t descartados;       // Fila cheia: o seq avança mesmo assim
+} telemetria_stats_t;
+
+// Prepara a fila de TELEMETRIA_CAPACIDADE registros. Antes de iniciar o agendador
+bool telemetria_init(void);
+
+// Enfileira um registro sem bloquear. Um único produtor
+bool telemetria_enviar(enq_tipo_t tipo, uint32_t t_us, const void *dados, uint8_t tam);
+
+// Espera registros e escreve os quadros na serial. A tarefa que chama esta
+// função pela primeira vez passa a ser a escritora
+void telemetria_escrever(TickType_t espera);
+
+telemetria_stats_t telemetria_stats(void);
+
+#endif // TELEMETRIA_H
@@ -0,0 +1,266 @@
+#include "ui.h"
+#include <string.h>
+
+#define UI_CELULA 8                     // Largura de um caractere monoespaçado
+
+void ui_init(ui_tela_t *tela, ssd1306_t *ssd) {
+    tela->ssd = ssd;
+    tela->num_widgets = 0;
+}
+
+static ui_widget_t *novo(ui_tela_t *tela, ui_tipo_t tipo, uint8_t x, uint8_t y, uint8_t largura, uint8_t altura) {
+    if (tela->num_widgets >= UI_MAX_WIDGETS)
+        return NULL;
+    ui_widget_t *w = &tela->widgets[tela->num_widgets++];
+    memset(w, 0, sizeof(*w));
+    w->tipo = tipo;
+    w->x = x;
+    w->y = y;
+    w->largura = largura;
+    w->altura = altura;
+    w->sujo = true;
+    return w;
+}
+
+ui_widget_t *ui_rotulo(ui_tela_t *tela, uint8_t x, uint8_t y, const char *texto) {
+    ui_widget_t *w = novo(tela, UI_ROTULO, x, y, 0, 8);
+    if (w)
+        ui_set_texto(w, texto);
+    return w;
+}
+
+ui_widget_t *ui_numero(ui_tela_t *tela, uint8_t x, uint8_t y, uint8_t digitos) {
+    if (digitos > UI_MAX_DIGITOS)
+        digitos = UI_MAX_DIGITOS;
+    ui_widget_t *w = novo(tela, UI_NUMERO, x, y, digitos * UI_CELULA, 8);
+    if (w)
+        w->numero.digitos = digitos;
+    return w;
+}
+
+ui_widget_t *ui_barra(ui_tela_t *tela, uint8_t x, uint8_t y, uint8_t largura, uint8_t altura, uint16_t maximo) {
+    if (largura < 3 || altura < 3)
+        return NULL;
+    ui_widget_t *w = novo(tela, UI_BARRA, x, y, largura, altura);
+    if (w)
+        w->barra.maximo = maximo ? maximo : 1;
+    return w;
+}
+
+ui_widget_t *ui_faixa(ui_tela_t *tela, uint8_t x, uint8_t y, uint8_t largura, uint8_t altura) {
+    return novo(tela, UI_FAIXA, x, y, largura, altura);
+}
+
+// y e altura em páginas inteiras; a largura não passa do número de amostras guardadas
+ui_widget_t *ui_grafico(ui_tela_t *tela, uint8_t x, uint8_t y, uint8_t largura, uint8_t altura,
+                        uint16_t maximo, ui_serie_t *serie) {
+    if (serie == NULL || largura < 2 || largura > UI_GRAFICO_MAX || altura < 8 || (y | altura) % 8)
+        return NULL;
+    ui_widget_t *w = novo(tela, UI_GRAFICO, x, y, largura, altura);
+    if (w) {
+        memset(serie, 0, sizeof(*serie));
+        w->grafico.serie = serie;
+        w->grafico.maximo = maximo ? maximo : 1;
+    }
+    return w;
+}
+
+void ui_set_texto(ui_widget_t *w, const char *texto) {
+    if (w->tipo != UI_ROTULO || strncmp(w->rotulo.texto, texto, UI_MAX_TEXTO) == 0)
+        return;
+    // O texto antigo é apagado por inteiro no próximo desenho
+    size_t n = strlen(texto);
+    uint8_t largura = (n > UI_MAX_TEXTO ? UI_MAX_TEXTO : n) * UI_CELULA;
+    if (largura > w->largura)
+        w->largura = largura;
+    strncpy(w->rotulo.texto, texto, UI_MAX_TEXTO);
+    w->desenhado = false;
+    w->sujo = true;
+}
+
+void ui_set_valor(ui_widget_t *w, int32_t valor) {
+    if (w->tipo == UI_NUMERO && valor != w->numero.valor) {
+        w->numero.valor = valor;
+        w->sujo = true;
+    } else if (w->tipo == UI_BARRA) {
+        uint16_t v = valor < 0 ? 0 : valor > w->barra.maximo ? w->barra.maximo : (uint16_t)valor;
+        if (v != w->barra.valor) {
+            w->barra.valor = v;
+            w->sujo = true;
+        }
+    }
+}
+
+void ui_set_faixa(ui_widget_t *w, const char *titulo, const char *detalhe) {
+    if (w->tipo != UI_FAIXA)
+        return;
+    if (detalhe == NULL)
+        detalhe = "";
+    bool igual_titulo = titulo == w->faixa.titulo ||
+                        (titulo && w->faixa.titulo && strcmp(titulo, w->faixa.titulo) == 0);
+    if (igual_titulo && strncmp(detalhe, w->faixa.detalhe, UI_MAX_TEXTO) == 0)
+        return;
+    w->faixa.titulo = titulo;
+    strncpy(w->faixa.detalhe, detalhe, UI_MAX_TEXTO);
+    w->faixa.detalhe[UI_MAX_TEXTO] = '\0';
+    w->desenhado = false;
+    w->sujo = true;
+}
+
+void ui_grafico_adicionar(ui_widget_t *w, const uint16_t valores[UI_GRAFICO_SERIES]) {
+    if (w->tipo != UI_GRAFICO)
+        return;
+    ui_serie_t *s = w->grafico.serie;
+    uint8_t i = (s->inicio + s->n) % UI_GRAFICO_MAX;
+    if (s->n < UI_GRAFICO_MAX)
+        s->n++;
+    else
+        s->inicio = (s->inicio + 1) % UI_GRAFICO_MAX;     // Cheia: descarta a mais antiga
+    memcpy(s->valores[i], valores, sizeof(s->valores[i]));
+    s->total++;
+    if (w->grafico.pendentes < 255)
+        w->grafico.pendentes++;
+    w->sujo = true;
+}
+
+// Escreve o valor alinhado à esquerda, completando as células com espaços
+static void formatar(char *s, int32_t valor, uint8_t digitos) {
+    char tmp[12];
+    uint8_t n = 0;
+    uint32_t v = valor < 0 ? -(uint32_t)valor : (uint32_t)valor;
+    do {
+        tmp[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v && n < sizeof(tmp) - 1);
+    if (valor < 0)
+        tmp[n++] = '-';
+
+    uint8_t i = 0;
+    if (n > digitos) {                  // Não cabe: mostra só '*'
+        while (i < digitos)
+            s[i++] = '*';
+    } else {
+        while (n)
+            s[i++] = tmp[--n];
+        while (i < digitos)
+            s[i++] = ' ';
+    }
+    s[i] = '\0';
+}
+
+static void desenhar_numero(ssd1306_t *ssd, ui_widget_t *w) {
+    char novo[UI_MAX_DIGITOS + 1];
+    formatar(novo, w->numero.valor, w->numero.digitos);
+    for (uint8_t i = 0; i < w->numero.digitos; i++)
+        if (!w->desenhado || novo[i] != w->numero.na_tela[i])
+            ssd1306_draw_char(ssd, novo[i], w->x + i * UI_CELULA, w->y);
+    memcpy(w->numero.na_tela, novo, sizeof(novo));
+}
+
+static void desenhar_barra(ssd1306_t *ssd, ui_widget_t *w) {
+    uint8_t interno = w->largura - 2;
+    uint8_t alvo = (uint32_t)w->barra.valor * interno / w->barra.maximo;
+    if (!w->desenhado) {
+        ssd1306_rect(ssd, w->y, w->x, w->largura, w->altura, true, false);
+        ssd1306_rect(ssd, w->y + 1, w->x + 1, interno, w->altura - 2, false, true);
+        w->barra.preenchido = 0;
+    }
+    // Só as colunas entre o preenchimento antigo e o novo mudam
+    uint8_t atual = w->barra.preenchido;
+    if (alvo > atual)
+        ssd1306_rect(ssd, w->y + 1, w->x + 1 + atual, alvo - atual, w->altura - 2, true, true);
+    else if (alvo < atual)
+        ssd1306_rect(ssd, w->y + 1, w->x + 1 + alvo, atual - alvo, w->altura - 2, false, true);
+    w->barra.preenchido = alvo;
+}
+
+static uint8_t centralizar(const ui_widget_t *w, uint8_t largura_texto) {
+    return largura_texto >= w->largura ? w->x : w->x + (w->largura - largura_texto) / 2;
+}
+
+static void desenhar_faixa(ssd1306_t *ssd, ui_widget_t *w) {
+    ssd1306_rect(ssd, w->y, w->x, w->largura, w->altura, false, true);
+    uint8_t largura_detalhe = strlen(w->faixa.detalhe) * UI_CELULA;
+    if (w->faixa.titulo) {
+        // Título (16 linhas) e detalhe (8) juntos, centralizados na altura
+        const char *t = w->faixa.titulo;
+        uint8_t y = w->altura > 24 ? w->y + (w->altura - 24) / 2 : w->y;
+        ssd1306_draw_string_2x(ssd, t, centralizar(w, ssd1306_string_width(t, 2)), y);
+        ssd1306_draw_string(ssd, w->faixa.detalhe, centralizar(w, largura_detalhe), y + 16);
+    } else {
+        ssd1306_draw_string(ssd, w->faixa.detalhe, centralizar(w, largura_detalhe), w->y + (w->altura - 8) / 2);
+    }
+}
+
+static uint8_t grafico_y(const ui_widget_t *w, uint16_t v) {
+    if (v > w->grafico.maximo)
+        v = w->grafico.maximo;
+    return w->y + w->altura - 1 - (uint32_t)v * (w->altura - 1) / w->grafico.maximo;
+}
+
+// Desenha a amostra k (0 = mais antiga guardada) na coluna x, já apagada. A
+// série 1 liga o valor anterior ao atual com um traço vertical; a série 0 é um
+// ponto a cada duas amostras, pela posição absoluta para o pontilhado rolar junto
+static void grafico_coluna(ssd1306_t *ssd, const ui_widget_t *w, uint8_t k, uint8_t x) {
+    const ui_serie_t *s = w->grafico.serie;
+    const uint16_t *v = s->valores[(s->inicio + k) % UI_GRAFICO_MAX];
+    uint8_t y1 = grafico_y(w, v[1]);
+    uint8_t y0 = k > 0 ? grafico_y(w, s->valores[(s->inicio + k - 1) % UI_GRAFICO_MAX][1]) : y1;
+    ssd1306_vline(ssd, x, y0, y1, true);
+    if ((s->total - s->n + k) % 2 == 0)
+        ssd1306_pixel(ssd, x, grafico_y(w, v[0]), true);
+}
+
+static void desenhar_grafico(ssd1306_t *ssd, ui_widget_t *w) {
+    const ui_serie_t *s = w->grafico.serie;
+    uint8_t ultima = w->x + w->largura - 1;
+    uint8_t pendentes = w->grafico.pendentes > s->n ? s->n : w->grafico.pendentes;
+    w->grafico.pendentes = 0;
+
+    if (!w->desenhado || pendentes >= w->largura) {
+        // Redesenho completo, com as amostras mais novas encostadas à direita
+        ssd1306_rect(ssd, w->y, w->x, w->largura, w->altura, false, true);
+        uint8_t visiveis = s->n < w->largura ? s->n : w->largura;
+        for (uint8_t j = 0; j < visiveis; j++)
+            grafico_coluna(ssd, w, s->n - visiveis + j, ultima - visiveis + 1 + j);
+        return;
+    }
+    // Cada amostra nova rola o gráfico uma coluna e ocupa a coluna da direita
+    uint8_t pagina0 = w->y / 8, pagina1 = (w->y + w->altura) / 8 - 1;
+    for (uint8_t j = pendentes; j > 0; j--) {
+        ssd1306_shift_left(ssd, w->x, ultima, pagina0, pagina1);
+        ssd1306_vline(ssd, ultima, w->y, w->y + w->altura - 1, false);
+        grafico_coluna(ssd, w, s->n - j, ultima);
+    }
+}
+
+bool ui_desenhar(ui_tela_t *tela) {
+    bool desenhou = false;
+    for (uint8_t i = 0; i < tela->num_widgets; i++) {
+        ui_widget_t *w = &tela->widgets[i];
+        if (!w->sujo)
+            continue;
+        switch (w->tipo) {
+        case UI_ROTULO:
+            ssd1306_rect(tela->ssd, w->y, w->x, w->largura, w->altura, false, true);
+            ssd1306_draw_string(tela->ssd, w->rotulo.texto, w->x, w->y);
+            break;
+        case UI_NUMERO:
+            desenhar_numero(tela->ssd, w);
+            break;
+        case UI_BARRA:
+            desenhar_barra(tela->ssd, w);
+            break;
+        case UI_FAIXA:
+            desenhar_faixa(tela->ssd, w);
+            break;
+        case UI_GRAFICO:
+            desenhar_grafico(tela->ssd, w);
+            break;
+        }
+        w->sujo = false;
+        w->desenhado = true;
+        desenhou = true;
+    }
+    return desenhou;
+}
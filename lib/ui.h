@@ -0,0 +1,96 @@
+#ifndef UI_H
+#define UI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+
+// Camada de widgets retidos sobre o ssd1306_t
+//
+// A tela guarda o estado de cada widget (rótulo, campo numérico, barra, faixa
+// de alerta e gráfico de tendência). Os setters só marcam o widget como
+// alterado quando o valor muda, e ui_desenhar() rasteriza apenas a área que
+// mudou: os caracteres diferentes de um número, as colunas entre o
+// preenchimento antigo e o novo de uma barra, a coluna nova de um gráfico.
+// Uma tela sem mudanças não toca no ram_buffer nem gera tráfego I2C.
+
+#define UI_MAX_WIDGETS 12
+#define UI_MAX_TEXTO 16
+#define UI_MAX_DIGITOS 6
+#define UI_GRAFICO_SERIES 2
+#define UI_GRAFICO_MAX 128              // Amostras guardadas (uma por coluna)
+
+typedef enum {
+    UI_ROTULO,
+    UI_NUMERO,
+    UI_BARRA,
+    UI_FAIXA,
+    UI_GRAFICO,
+} ui_tipo_t;
+
+// Amostras de um gráfico, em fila circular. Fica fora do widget porque é grande
+typedef struct {
+    uint16_t valores[UI_GRAFICO_MAX][UI_GRAFICO_SERIES];
+    uint8_t inicio, n;
+    uint32_t total;                     // Amostras recebidas desde o início (fase do pontilhado)
+} ui_serie_t;
+
+typedef struct {
+    ui_tipo_t tipo;
+    uint8_t x, y, largura, altura;
+    bool sujo;                          // Precisa ser rasterizado
+    bool desenhado;                     // Já está no ram_buffer (senão desenha por inteiro)
+    union {
+        struct {                        // Rótulo: texto monoespaçado, escala 1
+            char texto[UI_MAX_TEXTO + 1];
+        } rotulo;
+        struct {                        // Número alinhado à esquerda em 'digitos' células
+            int32_t valor;
+            uint8_t digitos;
+            char na_tela[UI_MAX_DIGITOS + 1];
+        } numero;
+        struct {                        // Barra com contorno, preenchida até valor/maximo
+            uint16_t valor, maximo;
+            uint8_t preenchido;         // Colunas preenchidas na tela
+        } barra;
+        struct {                        // Faixa: título ampliado 2x (opcional) e detalhe
+            const char *titulo;
+            char detalhe[UI_MAX_TEXTO + 1];
+        } faixa;
+        struct {                        // Série 0 pontilhada, série 1 em traço contínuo
+            ui_serie_t *serie;
+            uint16_t maximo;
+            uint8_t pendentes;          // Amostras ainda não desenhadas
+        } grafico;
+    };
+} ui_widget_t;
+
+typedef struct {
+    ssd1306_t *ssd;
+    ui_widget_t widgets[UI_MAX_WIDGETS];
+    uint8_t num_widgets;
+} ui_tela_t;
+
+void ui_init(ui_tela_t *tela, ssd1306_t *ssd);
+
+// Criação dos widgets; retornam NULL se a tela já tem UI_MAX_WIDGETS
+ui_widget_t *ui_rotulo(ui_tela_t *tela, uint8_t x, uint8_t y, const char *texto);
+ui_widget_t *ui_numero(ui_tela_t *tela, uint8_t x, uint8_t y, uint8_t digitos);
+ui_widget_t *ui_barra(ui_tela_t *tela, uint8_t x, uint8_t y, uint8_t largura, uint8_t altura, uint16_t maximo);
+ui_widget_t *ui_faixa(ui_tela_t *tela, uint8_t x, uint8_t y, uint8_t largura, uint8_t altura);
+// O gráfico ocupa páginas inteiras (y e altura múltiplos de 8) para poder rolar
+// com ssd1306_shift_left: cada amostra nova desloca o traço uma coluna
+ui_widget_t *ui_grafico(ui_tela_t *tela, uint8_t x, uint8_t y, uint8_t largura, uint8_t altura,
+                        uint16_t maximo, ui_serie_t *serie);
+
+void ui_set_texto(ui_widget_t *w, const char *texto);
+void ui_set_valor(ui_widget_t *w, int32_t valor);
+// O título da faixa não é copiado (deve ser constante); o detalhe é copiado e
+// pode vir de um texto formatado a cada amostra
+void ui_set_faixa(ui_widget_t *w, const char *titulo, const char *detalhe);
+void ui_grafico_adicionar(ui_widget_t *w, const uint16_t valores[UI_GRAFICO_SERIES]);
+
+// Rasteriza os widgets alterados. Retorna true se algo foi desenhado
+bool ui_desenhar(ui_tela_t *tela);
+
+#endif // UI_H
@@ -0,0 +1,23 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "hal_host.h"
+#include "teste.h"
+
+int teste_falhas = 0;
+
+// Os testes terminam sozinhos; um teste travado é interrompido pelo TIMEOUT do ctest
+const uint32_t host_duracao_padrao_ms = 0;
+
+int teste_resultado(const char *nome) {
+    if (teste_falhas) {
+        printf("%s: %d falha(s)\n", nome, teste_falhas);
+        return 1;
+    }
+    printf("%s: ok\n", nome);
+    return 0;
+}
+
+const char *teste_caminho(const char *nome) {
+    static char caminho[512];
+    return host_caminho_saida(nome, caminho, sizeof(caminho));
+}
@@ -0,0 +1,34 @@
+// Verificações dos testes da simulação nativa (tests/)
+#ifndef TESTE_H
+#define TESTE_H
+
+#include <stdio.h>
+
+// Falhas acumuladas; cada verificação que falha imprime o arquivo e a linha
+extern int teste_falhas;
+
+#define VERIFICAR(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+            teste_falhas++; \
+        } \
+    } while (0)
+
+// Compara dois inteiros e imprime os dois valores se forem diferentes
+#define VERIFICAR_IGUAL(obtido, esperado) \
+    do { \
+        long long obtido_ = (long long)(obtido), esperado_ = (long long)(esperado); \
+        if (obtido_ != esperado_) { \
+            fprintf(stderr, "%s:%d: %s = %lld, esperado %lld\n", __FILE__, __LINE__, #obtido, obtido_, esperado_); \
+            teste_falhas++; \
+        } \
+    } while (0)
+
+// Imprime o resultado e retorna o código de saída do teste
+int teste_resultado(const char *nome);
+
+// Caminho de um arquivo no diretório de saída do teste (ESTACAO_SIM_DIR)
+const char *teste_caminho(const char *nome);
+
+#endif // TESTE_H
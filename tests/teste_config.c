@@ -0,0 +1,156 @@
+// Configuração pela serial: leitor de comandos, validação, gravação com CRC e
+// aplicação pela aquisição
+//
+// As linhas entram caractere a caractere por config_caractere, como na tarefa
+// da serial, e a resposta impressa é capturada para conferir a linha
+// '# config,...'. Depois de um :gravar, config_init é a partida seguinte sobre a
+// mesma flash; um bit limpo em um registro (gravação parcial) deve fazê-lo ser
+// ignorado pelo CRC.
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "config.h"
+#include "canais_estacao.h"
+#include "historico.h"
+#include "teste.h"
+
+#define CONFIG_OFFSET (PICO_FLASH_SIZE_BYTES - HISTORICO_TAMANHO - FLASH_SECTOR_SIZE)
+#define PERIODO_PADRAO_MS 100
+
+static char resposta[8192];
+
+// Envia ':<linha>\n' ao leitor e devolve o que foi impresso
+static const char *executar(const char *texto) {
+    fflush(stdout);
+    int salvo = dup(STDOUT_FILENO);
+    FILE *f = tmpfile();
+    if (salvo < 0 || !f) {
+        perror("tmpfile");
+        exit(1);
+    }
+    dup2(fileno(f), STDOUT_FILENO);
+    config_caractere(CONFIG_COMANDO);
+    for (const char *c = texto; *c; c++)
+        config_caractere(*c);
+    config_caractere('\n');
+    fflush(stdout);
+    dup2(salvo, STDOUT_FILENO);
+    close(salvo);
+
+    rewind(f);
+    size_t n = fread(resposta, 1, sizeof(resposta) - 1, f);
+    resposta[n] = '\0';
+    fclose(f);
+    return resposta;
+}
+
+// A resposta contém o trecho esperado (em geral a linha '# config,...')
+#define RESPOSTA(texto, esperado) \
+    do { \
+        const char *r_ = executar(texto); \
+        if (!strstr(r_, esperado)) { \
+            fprintf(stderr, "%s:%d: :%s respondeu \"%s\", esperado \"%s\"\n", __FILE__, __LINE__, texto, r_, esperado); \
+            teste_falhas++; \
+        } \
+    } while (0)
+
+// Limpa um bit do registro 'i' da configuração, como uma programação interrompida
+static void corromper_registro(uint8_t i, uint32_t byte, uint8_t mascara) {
+    static uint8_t pagina[FLASH_PAGE_SIZE];
+    memset(pagina, 0xFF, sizeof(pagina));
+    pagina[byte] = (uint8_t)~mascara;
+    flash_range_program(CONFIG_OFFSET + i * FLASH_PAGE_SIZE, pagina, FLASH_PAGE_SIZE);
+}
+
+int main(void) {
+    unlink(teste_caminho("flash.bin"));
+    canais_init(canais_estacao, canais_estacao_num);
+    config_init(PERIODO_PADRAO_MS);
+    uint16_t periodo = 0;
+
+    // Leitura: uma chave e a tabela inteira (período + 11 parâmetros por canal)
+    VERIFICAR(!config_caractere('h'));
+    RESPOSTA("ler chuva.alerta", "config,chuva.alerta,85.0\n# config,ok,1,padrao");
+    RESPOSTA("ler temperatura.aviso", "config,temperatura.aviso,-\n");
+    RESPOSTA("ler periodo_ms", "config,periodo_ms,100\n");
+    RESPOSTA("ler", "# config,ok,45,padrao");
+
+    // Valores fora da faixa, chaves e comandos desconhecidos: nada é publicado
+    RESPOSTA("ajustar periodo_ms=19", "# config,erro,periodo_ms fora da faixa");
+    RESPOSTA("ajustar periodo_ms=1001", "# config,erro,periodo_ms fora da faixa");
+    RESPOSTA("ajustar periodo_ms=70000", "# config,erro,valor periodo_ms");
+    RESPOSTA("ajustar chuva.aviso=90", "# config,erro,limiares fora de ordem");
+    RESPOSTA("ajustar chuva.histerese=-0.1", "# config,erro,histerese, margem ou permanencia invalida");
+    RESPOSTA("ajustar nivel.permanencia_ms=600001", "# config,erro,histerese, margem ou permanencia invalida");
+    RESPOSTA("ajustar chuva.mediana=4", "# config,erro,filtro invalido");
+    RESPOSTA("ajustar chuva.mediana=9", "# config,erro,filtro invalido");
+    RESPOSTA("ajustar nivel.ema_k=16", "# config,erro,filtro invalido");
+    RESPOSTA("ajustar nivel.tendencia=17", "# config,erro,filtro invalido");
+    RESPOSTA("ajustar nivel.janela=65", "# config,erro,previsao invalida");
+    RESPOSTA("ajustar nivel.horizonte_s=3601", "# config,erro,previsao invalida");
+    RESPOSTA("ajustar nivel.horizonte_s=70000", "# config,erro,valor nivel.horizonte_s");
+    RESPOSTA("ajustar chuva.aviso=1.25", "# config,erro,valor chuva.aviso");
+    RESPOSTA("ajustar chuva.aviso=abc", "# config,erro,valor chuva.aviso");
+    RESPOSTA("ajustar vento.aviso=1", "# config,erro,chave vento.aviso");
+    RESPOSTA("ajustar chuva.aviso", "# config,erro,chave chuva.aviso");
+    RESPOSTA("ajustar", "# config,erro,nada a ajustar");
+    RESPOSTA("apagar", "# config,erro,comando apagar");
+    RESPOSTA("ler periodo_ms chuva.aviso=1 chuva.aviso=1 chuva.aviso=1 chuva.aviso=1 chuva.aviso=1 chuva.aviso=1",
+             "# config,erro,linha longa");
+
+    // Uma atribuição inválida recusa a linha inteira
+    RESPOSTA("ajustar periodo_ms=200 chuva.mediana=4", "# config,erro,filtro invalido");
+    RESPOSTA("ler periodo_ms", "config,periodo_ms,100\n");
+    VERIFICAR(!config_aplicar(&periodo));
+
+    // Ajuste aceito: publicado para a serial, aplicado só por config_aplicar
+    RESPOSTA("ajustar periodo_ms=200 chuva.alerta=80.5 nivel.critico=- chuva.ema_k=3", "# config,ok,4\n");
+    RESPOSTA("ler chuva.alerta", "config,chuva.alerta,80.5\n# config,ok,1,alterada");
+    VERIFICAR_IGUAL(canais_alarme(0)->limiar[ALARME_ALERTA], 850);
+    VERIFICAR_IGUAL(config_periodo_ms(), PERIODO_PADRAO_MS);
+    VERIFICAR(config_aplicar(&periodo));
+    VERIFICAR_IGUAL(periodo, 200);
+    VERIFICAR_IGUAL(config_periodo_ms(), 200);
+    VERIFICAR_IGUAL(canais_alarme(0)->limiar[ALARME_ALERTA], 805);
+    VERIFICAR_IGUAL(alarme_limiar(0, ALARME_ALERTA), 805);
+    VERIFICAR_IGUAL(canais_alarme(1)->limiar[ALARME_CRITICO], INT32_MAX);
+    VERIFICAR_IGUAL(canais_filtro(0)->ema_k, 3);
+    VERIFICAR(!config_aplicar(&periodo));
+
+    // Gravação: a partida seguinte carrega o registro mais novo
+    RESPOSTA("gravar", "# config,ok,gravada,");
+    RESPOSTA("ajustar periodo_ms=300", "# config,ok,1\n");
+    VERIFICAR(config_aplicar(&periodo));
+    RESPOSTA("gravar", "# config,ok,gravada,");
+
+    config_init(PERIODO_PADRAO_MS);
+    VERIFICAR_IGUAL(config_periodo_ms(), 300);
+    VERIFICAR_IGUAL(canais_alarme(0)->limiar[ALARME_ALERTA], 805);
+    RESPOSTA("ler periodo_ms", "config,periodo_ms,300\n# config,ok,1,flash");
+
+    // Um bit limpo no período do registro mais novo (300 -> 296, ainda válido):
+    // o CRC o recusa e vale o anterior. Com os dois estragados, a tabela padrão
+    corromper_registro(1, 8, 0x04);
+    config_init(PERIODO_PADRAO_MS);
+    VERIFICAR_IGUAL(config_periodo_ms(), 200);
+    corromper_registro(0, 20, 0x01);
+    config_init(PERIODO_PADRAO_MS);
+    VERIFICAR_IGUAL(config_periodo_ms(), PERIODO_PADRAO_MS);
+    VERIFICAR_IGUAL(canais_alarme(0)->limiar[ALARME_ALERTA], 850);
+    VERIFICAR_IGUAL(canais_alarme(1)->limiar[ALARME_CRITICO], 879);
+
+    // :padrao volta à tabela e a próxima gravação usa uma página ainda apagada
+    RESPOSTA("ajustar periodo_ms=500", "# config,ok,1\n");
+    RESPOSTA("padrao", "# config,ok,padrao");
+    VERIFICAR(config_aplicar(&periodo));
+    VERIFICAR_IGUAL(periodo, PERIODO_PADRAO_MS);
+    RESPOSTA("ajustar periodo_ms=40", "# config,ok,1\n");
+    RESPOSTA("gravar", "# config,ok,gravada,");
+    config_init(PERIODO_PADRAO_MS);
+    VERIFICAR_IGUAL(config_periodo_ms(), 40);
+
+    return teste_resultado("teste_config");
+}
@@ -0,0 +1,163 @@
+// Quadros da telemetria: ida e volta exata pelo COBS e pelo CRC, rejeição de
+// quadros corrompidos e ressincronização em um fluxo com texto e lixo
+//
+// Também grava o fluxo em serial.bin, que o teste telemetria_decode passa pelo
+// decodificador de tools/ (tests/CMakeLists.txt).
+
+#include <string.h>
+#include "enquadramento.h"
+#include "teste.h"
+
+static uint32_t estado = 12345;
+
+static uint32_t aleatorio(void) {
+    estado ^= estado << 13;
+    estado ^= estado >> 17;
+    estado ^= estado << 5;
+    return estado;
+}
+
+// Registro com carga de um tipo: aleatória, só zeros, só 0xFF ou zeros alternados
+static enq_registro_t registro(uint8_t tipo_carga, uint8_t tam) {
+    enq_registro_t r = { .tipo = ENQ_AMOSTRA, .seq = (uint16_t)aleatorio(), .t_us = aleatorio(), .tam = tam };
+    if (tipo_carga != 0)
+        r.seq &= 0xFF00;                // Zeros também no cabeçalho
+    if (tipo_carga == 1)
+        r.t_us &= 0x00FF0000;
+    for (uint8_t i = 0; i < tam; i++) {
+        switch (tipo_carga) {
+        case 0: r.dados[i] = (uint8_t)aleatorio(); break;
+        case 1: r.dados[i] = 0x00; break;
+        case 2: r.dados[i] = 0xFF; break;
+        default: r.dados[i] = i & 1 ? 0x00 : (uint8_t)(aleatorio() | 1); break;
+        }
+    }
+    return r;
+}
+
+static bool iguais(const enq_registro_t *a, const enq_registro_t *b) {
+    return a->tipo == b->tipo && a->seq == b->seq && a->t_us == b->t_us && a->tam == b->tam &&
+           memcmp(a->dados, b->dados, a->tam) == 0;
+}
+
+// Codifica, confere o formato do quadro e decodifica o conteúdo entre os zeros
+static void ida_e_volta(const enq_registro_t *r) {
+    uint8_t q[ENQ_MAX_QUADRO];
+    size_t n = enq_codificar(r, q);
+    VERIFICAR(n >= 2 + ENQ_CABECALHO + 2 + 1 && n <= ENQ_MAX_QUADRO);
+    VERIFICAR(q[0] == 0 && q[n - 1] == 0);
+    VERIFICAR(memchr(&q[1], 0, n - 2) == NULL);     // Nenhum zero dentro do quadro
+
+    enq_registro_t d;
+    VERIFICAR(enq_decodificar(&q[1], n - 2, &d));
+    VERIFICAR(iguais(r, &d));
+}
+
+// Cada bit trocado no conteúdo do quadro deve ser rejeitado (ou virar um
+// delimitador, quando o byte passa a ser zero)
+static uint32_t corromper(const enq_registro_t *r) {
+    uint8_t q[ENQ_MAX_QUADRO];
+    size_t n = enq_codificar(r, q);
+    uint32_t aceitos = 0;
+    for (size_t i = 1; i + 1 < n; i++) {
+        for (int b = 0; b < 8; b++) {
+            q[i] ^= 1u << b;
+            enq_registro_t d;
+            if (q[i] != 0 && enq_decodificar(&q[1], n - 2, &d))
+                aceitos++;
+            q[i] ^= 1u << b;
+        }
+    }
+
+    // Quadro truncado e quadro curto demais
+    enq_registro_t d;
+    VERIFICAR(!enq_decodificar(&q[1], n - 3, &d));
+    VERIFICAR(!enq_decodificar(&q[1], 3, &d));
+    return aceitos;
+}
+
+// Separa o fluxo nos zeros, como tools/telemetria_decode.c
+static void separar(const uint8_t *fluxo, size_t n, uint32_t *validos, uint32_t *invalidos, enq_registro_t *saida) {
+    size_t inicio = 0;
+    *validos = *invalidos = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (fluxo[i] != 0)
+            continue;
+        if (i > inicio) {
+            if (enq_decodificar(&fluxo[inicio], i - inicio, &saida[*validos]))
+                (*validos)++;
+            else
+                (*invalidos)++;
+        }
+        inicio = i + 1;
+    }
+}
+
+int main(void) {
+    // Valor de verificação do CRC-16/CCITT-FALSE
+    VERIFICAR_IGUAL(enq_crc16((const uint8_t *)"123456789", 9), 0x29B1);
+
+    uint32_t aceitos = 0;
+    for (uint8_t tipo_carga = 0; tipo_carga < 4; tipo_carga++) {
+        for (uint8_t tam = 0; tam <= ENQ_MAX_DADOS; tam++) {
+            for (int k = 0; k < 20; k++) {
+                enq_registro_t r = registro(tipo_carga, tam);
+                ida_e_volta(&r);
+                if (k == 0)
+                    aceitos += corromper(&r);
+            }
+        }
+    }
+    VERIFICAR_IGUAL(aceitos, 0);
+
+    // Carga maior que ENQ_MAX_DADOS é cortada no limite
+    enq_registro_t grande = registro(0, ENQ_MAX_DADOS);
+    grande.tam = 200;
+    uint8_t q[ENQ_MAX_QUADRO];
+    size_t n = enq_codificar(&grande, q);
+    enq_registro_t d;
+    VERIFICAR(enq_decodificar(&q[1], n - 2, &d));
+    VERIFICAR_IGUAL(d.tam, ENQ_MAX_DADOS);
+
+    // Fluxo: texto, um quadro, lixo sem zeros, um quadro corrompido, dois quadros
+    // (um com seq saltado), texto e um quadro sem o zero final
+    static uint8_t fluxo[1024];
+    size_t m = 0;
+    const char *texto = "estacao: iniciando\n";
+    enq_registro_t enviados[4] = {
+        { .tipo = ENQ_AMOSTRA, .seq = 10, .t_us = 1000, .tam = 3, .dados = { 1, 0xF4, 0x01 } },
+        { .tipo = ENQ_ALARME, .seq = 11, .t_us = 0, .tam = 2, .dados = { 2, 0 } },
+        { .tipo = ENQ_AMOSTRA, .seq = 12, .t_us = 0x00010000, .tam = 5, .dados = { 0, 0, 0, 0x9C, 0xFF } },
+        { .tipo = ENQ_ALARME, .seq = 14, .t_us = 0xFFFFFFFF, .tam = 2, .dados = { 0, 2 } },
+    };
+    memcpy(&fluxo[m], texto, strlen(texto));
+    m += strlen(texto);
+    m += enq_codificar(&enviados[0], &fluxo[m]);
+    for (int i = 0; i < 40; i++)
+        fluxo[m++] = (uint8_t)(aleatorio() | 1);
+    m += enq_codificar(&enviados[1], &fluxo[m]);
+    size_t corrompido = m;
+    m += enq_codificar(&enviados[2], &fluxo[m]);
+    fluxo[corrompido + 5] ^= 0x10;                  // Estraga o quadro de seq 12
+    m += enq_codificar(&enviados[2], &fluxo[m]);
+    m += enq_codificar(&enviados[3], &fluxo[m]);
+    memcpy(&fluxo[m], texto, strlen(texto));
+    m += strlen(texto);
+    m += enq_codificar(&enviados[0], &fluxo[m]) - 1;
+
+    enq_registro_t recebidos[8];
+    uint32_t validos, invalidos;
+    separar(fluxo, m, &validos, &invalidos, recebidos);
+    VERIFICAR_IGUAL(validos, 4);
+    VERIFICAR_IGUAL(invalidos, 4);                  // Os dois textos, o lixo e o quadro corrompido
+    for (uint32_t i = 0; i < validos && i < 4; i++)
+        VERIFICAR(iguais(&recebidos[i], &enviados[i]));
+
+    FILE *f = fopen(teste_caminho("serial.bin"), "wb");
+    VERIFICAR(f != NULL);
+    if (f) {
+        fwrite(fluxo, 1, m, f);
+        fclose(f);
+    }
+    return teste_resultado("teste_enquadramento");
+}
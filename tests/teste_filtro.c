@@ -0,0 +1,93 @@
+// Filtro das leituras: vetores fixos para a mediana, a média exponencial e a
+// tendência, incluindo o enchimento das janelas
+//
+// Os valores esperados foram calculados à mão a partir de filtro.c. Compilado
+// também com ESTACAO_SEM_FILTRO (teste_filtro_sem_filtro): a mediana e a média
+// passam a leitura adiante e só a tendência continua.
+
+#include "filtro.h"
+#include "teste.h"
+
+#define NUM_LEITURAS 12
+#define NUM_CANAIS 5
+#define PERIODO_US 100000
+
+static const filtro_config_t configs[NUM_CANAIS] = {
+    { .mediana = 3 },
+    { .ema_k = 2 },
+    { .mediana = 5, .ema_k = 1 },       // Mediana antes da média: o pico não chega à média
+    { .tendencia = 4 },
+    { 0 },                              // Tudo desligado
+};
+
+static const int32_t entradas[NUM_LEITURAS][NUM_CANAIS] = {
+    { 10, 100, 0, 0, 7 },
+    { 50, 100, 0, 10, -7 },
+    { 20, 200, 0, 20, 7 },
+    { 1000, 200, 900, 30, -7 },
+    { 30, 200, 0, 40, 7 },
+    { 40, -100, 0, 50, -7 },
+    { -500, -100, 400, 60, 7 },
+    { 60, -100, 400, 70, -7 },
+    { 40, -100, 400, 50, 7 },
+    { 40, -100, 400, 30, -7 },
+    { -7, -100, 400, 10, 7 },
+    { -7, -100, 400, -10, -7 },
+};
+
+#ifndef ESTACAO_SEM_FILTRO
+// Mediana de 3: com 2 leituras, a maior das duas. Média com alfa 1/4 em Q8,
+// arredondada (o deslocamento aritmético arredonda os negativos para baixo)
+static const int32_t saidas[NUM_LEITURAS][NUM_CANAIS] = {
+    { 10, 100, 0, 0, 7 },
+    { 50, 100, 0, 10, -7 },
+    { 20, 125, 0, 20, 7 },
+    { 50, 144, 0, 30, -7 },
+    { 30, 158, 0, 40, 7 },
+    { 40, 93, 0, 50, -7 },
+    { 30, 45, 0, 60, 7 },
+    { 40, 9, 200, 70, -7 },
+    { 40, -18, 300, 50, 7 },
+    { 40, -39, 350, 30, -7 },
+    { 40, -54, 375, 10, 7 },
+    { -7, -66, 388, -10, -7 },
+};
+#endif
+
+// Tendência de 4 leituras a cada 100 ms: (y - y[-4]) * 60000 / 400, em décimos por minuto
+static const int32_t tendencias_esperadas[NUM_LEITURAS] = {
+    0, 0, 0, 0, 6000, 6000, 6000, 6000, 1500, -3000, -7500, -12000,
+};
+
+int main(void) {
+    for (uint8_t c = 0; c < NUM_CANAIS; c++)
+        filtro_init(c, &configs[c]);
+
+    for (uint32_t k = 0; k < NUM_LEITURAS; k++) {
+        int32_t saida[NUM_CANAIS], tendencias[NUM_CANAIS];
+        filtro_processar(entradas[k], saida, tendencias, NUM_CANAIS, (uint64_t)k * PERIODO_US);
+        for (uint8_t c = 0; c < NUM_CANAIS; c++) {
+#ifdef ESTACAO_SEM_FILTRO
+            VERIFICAR_IGUAL(saida[c], entradas[k][c]);
+#else
+            VERIFICAR_IGUAL(saida[c], saidas[k][c]);
+#endif
+            VERIFICAR_IGUAL(tendencias[c], c == 3 ? tendencias_esperadas[k] : 0);
+        }
+    }
+    VERIFICAR_IGUAL(filtro_stats().leituras, NUM_LEITURAS);
+
+    // filtro_init recomeça as janelas: a primeira leitura passa inteira
+    filtro_init(1, &configs[1]);
+    filtro_init(3, &configs[3]);
+    int32_t entrada[NUM_CANAIS] = { -7, 500, 400, 1000, 0 }, saida[NUM_CANAIS], tendencias[NUM_CANAIS];
+    filtro_processar(entrada, saida, tendencias, NUM_CANAIS, NUM_LEITURAS * PERIODO_US);
+    VERIFICAR_IGUAL(saida[1], 500);
+    VERIFICAR_IGUAL(tendencias[3], 0);
+
+#ifdef ESTACAO_SEM_FILTRO
+    return teste_resultado("teste_filtro_sem_filtro");
+#else
+    return teste_resultado("teste_filtro");
+#endif
+}
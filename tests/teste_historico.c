@@ -0,0 +1,216 @@
+// Histórico na flash: corte de energia no meio de uma gravação e recuperação
+//
+// Um processo filho grava uma sequência conhecida de amostras (deltas pequenos,
+// negativos e de até 2^30) e alarmes, com ESTACAO_SIM_FLASH_CORTE cortando a
+// energia no meio da programação de uma página. A cada página gravada ele conta
+// ao pai, por um pipe, quantos registros já estão em páginas completas. O pai
+// então faz a partida sobre a mesma flash: a leitura deve devolver exatamente
+// esses registros, decodificados sem erro, ignorar a página cortada e continuar
+// o log depois dela na partida seguinte.
+//
+// Por fim o log dá a volta na região inteira e historico_ler é cronometrado:
+// a vazão em registros por segundo é impressa (linha historico_ler,...).
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "historico.h"
+#include "teste.h"
+
+#define NUM_REGISTROS 600
+#define CORTE 5                     // Programação de página em que a energia cai
+#define NUM_NOVOS 20                // Registros da partida seguinte ao corte
+#define NUM_PAGINAS (HISTORICO_TAMANHO / FLASH_PAGE_SIZE)
+#define VAZAO_MIN 100000            // Registros por segundo; folga grande para uma máquina carregada
+#define TEXTO(x) #x
+#define TEXTO_VALOR(x) TEXTO(x)
+
+static historico_registro_t esperados[NUM_REGISTROS + NUM_NOVOS];
+static uint64_t t_us[NUM_REGISTROS + NUM_NOVOS];
+
+static uint32_t estado = 2463534242u;
+
+static uint32_t aleatorio(void) {
+    estado ^= estado << 13;
+    estado ^= estado >> 17;
+    estado ^= estado << 5;
+    return estado;
+}
+
+// Um alarme a cada 7 registros; as amostras alternam faixas de 2^1 a 2^30, com
+// sinal, e às vezes repetem o valor anterior (delta zero)
+static void gerar(void) {
+    uint64_t t = 5000;
+    for (uint32_t i = 0; i < NUM_REGISTROS + NUM_NOVOS; i++) {
+        historico_registro_t *r = &esperados[i];
+        t += i % 50 == 49 ? 600000000u : 1000u * (aleatorio() % 250);  // 10 min de intervalo às vezes
+        t_us[i] = t;
+        r->t_ms = (uint32_t)(t / 1000);
+        r->boot = i < NUM_REGISTROS ? 0 : 1;
+        if (i % 7 == 3) {
+            r->tipo = HISTORICO_ALARME;
+            r->alarme = aleatorio() % 3;
+            r->anterior = aleatorio() % 3;
+            continue;
+        }
+        r->tipo = HISTORICO_AMOSTRA;
+        r->num_valores = CANAIS_MAX;
+        uint32_t faixa = 1 + i % 30;
+        for (int c = 0; c < CANAIS_MAX; c++) {
+            if (aleatorio() % 4 == 0 && i > 0)
+                r->valores[c] = esperados[i - 1].valores[c];
+            else
+                r->valores[c] = (int32_t)(aleatorio() % (2u << faixa)) - (int32_t)(1u << faixa);
+        }
+    }
+}
+
+static void registrar(uint32_t i) {
+    const historico_registro_t *r = &esperados[i];
+    if (r->tipo == HISTORICO_ALARME)
+        historico_alarme(t_us[i], r->alarme, r->anterior);
+    else
+        historico_amostra(t_us[i], r->valores, r->num_valores);
+}
+
+// Processo filho: grava até a energia cair. Uma página que fecha contém todos
+// os registros anteriores ao que não coube nela
+static void gravar_ate_o_corte(int saida) {
+    historico_init();
+    for (uint32_t i = 0; i < NUM_REGISTROS; i++) {
+        uint32_t gravadas = historico_stats().paginas_gravadas;
+        registrar(i);
+        historico_gravar(0);
+        if (historico_stats().paginas_gravadas != gravadas && write(saida, &i, sizeof(i)) != sizeof(i))
+            _exit(1);
+    }
+    _exit(0);                       // Sem corte: o pai acusa o erro
+}
+
+// Leitura esperada: os 'completos' primeiros registros e depois os da nova partida
+typedef struct {
+    uint32_t completos;
+    uint32_t lidos;
+    uint32_t diferentes;
+} leitura_t;
+
+static void conferir(const historico_registro_t *r, void *ctx) {
+    leitura_t *l = ctx;
+    uint32_t i = l->lidos < l->completos ? l->lidos : NUM_REGISTROS + (l->lidos - l->completos);
+    l->lidos++;
+    if (i >= NUM_REGISTROS + NUM_NOVOS) {
+        l->diferentes++;
+        return;
+    }
+    const historico_registro_t *e = &esperados[i];
+    bool igual = r->tipo == e->tipo && r->boot == e->boot && r->t_ms == e->t_ms;
+    if (igual && e->tipo == HISTORICO_AMOSTRA) {
+        igual = r->num_valores == e->num_valores &&
+                memcmp(r->valores, e->valores, e->num_valores * sizeof(int32_t)) == 0;
+    } else if (igual) {
+        igual = r->alarme == e->alarme && r->anterior == e->anterior;
+    }
+    if (!igual && l->diferentes++ < 5)
+        fprintf(stderr, "registro %u diferente do gravado\n", (unsigned)i);
+}
+
+typedef struct {
+    uint32_t lidos;
+    uint32_t fora_de_ordem;
+    uint32_t t_ms;
+} volta_t;
+
+static void contar(const historico_registro_t *r, void *ctx) {
+    volta_t *v = ctx;
+    if (v->lidos && r->t_ms < v->t_ms)
+        v->fora_de_ordem++;
+    v->t_ms = r->t_ms;
+    v->lidos++;
+}
+
+// Enche a região inteira e mais um setor, para o mais antigo ser apagado, e
+// cronometra a leitura do log cheio
+static void vazao_leitura(uint64_t t) {
+    int32_t valores[CANAIS_MAX] = { 0 };
+    uint32_t gravados = 0;
+    while (historico_stats().paginas_gravadas < NUM_PAGINAS + FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE) {
+        t += 100000;
+        for (int c = 0; c < CANAIS_MAX; c++)
+            valores[c] += (int32_t)(aleatorio() % 201) - 100;
+        historico_amostra(t, valores, CANAIS_MAX);
+        historico_gravar(0);
+        gravados++;
+    }
+
+    volta_t v = { 0 };
+    uint64_t inicio = time_us_64();
+    uint32_t n = historico_ler(contar, &v);
+    uint64_t duracao_us = time_us_64() - inicio;
+    uint64_t por_s = duracao_us ? (uint64_t)n * 1000000u / duracao_us : UINT64_MAX;
+    printf("historico_ler,%u,%llu,%llu\n", (unsigned)n, (unsigned long long)duracao_us, (unsigned long long)por_s);
+
+    VERIFICAR_IGUAL(v.lidos, n);
+    VERIFICAR_IGUAL(v.fora_de_ordem, 0);
+    VERIFICAR(n > 0 && n < gravados);           // O setor mais antigo foi apagado
+    VERIFICAR(por_s >= VAZAO_MIN);
+}
+
+int main(void) {
+    gerar();
+    unlink(teste_caminho("flash.bin"));
+
+    int tubo[2];
+    if (pipe(tubo) != 0) {
+        perror("pipe");
+        return 1;
+    }
+    setenv("ESTACAO_SIM_FLASH_CORTE", TEXTO_VALOR(CORTE), 1);
+    pid_t filho = fork();
+    if (filho == 0) {
+        close(tubo[0]);
+        gravar_ate_o_corte(tubo[1]);
+    }
+    close(tubo[1]);
+    unsetenv("ESTACAO_SIM_FLASH_CORTE");
+
+    // Registros em páginas completas, segundo a última página que o filho terminou
+    uint32_t completos = 0, paginas = 0, n;
+    while (read(tubo[0], &n, sizeof(n)) == sizeof(n)) {
+        completos = n;
+        paginas++;
+    }
+    int status = 0;
+    waitpid(filho, &status, 0);
+    VERIFICAR(WIFEXITED(status) && WEXITSTATUS(status) == 3);     // Saída do corte em hal_flash.c
+    VERIFICAR_IGUAL(paginas, CORTE - 1);
+    VERIFICAR(completos > 0 && completos < NUM_REGISTROS);
+
+    // Partida depois do corte: as páginas completas valem, a cortada não
+    VERIFICAR(historico_init());
+    historico_stats_t s = historico_stats();
+    VERIFICAR_IGUAL(s.paginas_validas, CORTE - 1);
+    VERIFICAR_IGUAL(s.boot, 1);
+
+    leitura_t l = { .completos = completos };
+    VERIFICAR_IGUAL(historico_ler(conferir, &l), completos);
+    VERIFICAR_IGUAL(l.lidos, completos);
+    VERIFICAR_IGUAL(l.diferentes, 0);
+
+    // A gravação continua depois da página cortada, sem perder o que já estava lá.
+    // Os novos registros abrem uma página, e os deltas partem de zero outra vez
+    for (uint32_t i = NUM_REGISTROS; i < NUM_REGISTROS + NUM_NOVOS; i++)
+        registrar(i);
+    historico_fechar_pagina();
+    for (int i = 0; i < HISTORICO_PAGINAS_RAM; i++)
+        historico_gravar(0);
+    VERIFICAR_IGUAL(historico_stats().paginas_perdidas, 0);
+    l = (leitura_t){ .completos = completos };
+    VERIFICAR_IGUAL(historico_ler(conferir, &l), completos + NUM_NOVOS);
+    VERIFICAR_IGUAL(l.diferentes, 0);
+
+    vazao_leitura(t_us[NUM_REGISTROS + NUM_NOVOS - 1]);
+    return teste_resultado("teste_historico");
+}
@@ -0,0 +1,63 @@
+// Percentis da latência estimados pelo histograma em potências de 2
+//
+// As medidas são registradas com o instante da amostra deslocado para trás,
+// de modo que a latência é conhecida (mais o microssegundo entre as chamadas).
+// O relógio da simulação começa em zero: o teste espera até ele passar da
+// maior latência usada.
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "latencia.h"
+#include "teste.h"
+
+static void registrar(latencia_sonda_t sonda, uint32_t us) {
+    latencia_registrar(sonda, time_us_64() - us);
+}
+
+// Estimativa dentro de 'tolerancia' por cento do valor exato
+static void verificar_perto(uint32_t obtido, uint32_t exato, uint32_t tolerancia, int linha) {
+    if ((uint64_t)abs((int32_t)(obtido - exato)) * 100 > (uint64_t)exato * tolerancia) {
+        fprintf(stderr, "linha %d: %lu, esperado %lu +/- %lu%%\n", linha, (unsigned long)obtido,
+                (unsigned long)exato, (unsigned long)tolerancia);
+        teste_falhas++;
+    }
+}
+
+#define MAIOR_LATENCIA_US 600000    // Acima do início da última faixa (2^19 us)
+
+int main(void) {
+    while (time_us_64() <= MAIOR_LATENCIA_US)
+        sleep_ms(10);
+
+    // Sem medidas
+    VERIFICAR_IGUAL(latencia_percentil(LATENCIA_LED, 500), 0);
+
+    // Distribuição uniforme de 10 a 10000 us: p50 = 5000, p99 = 9900
+    for (uint32_t i = 1; i <= 1000; i++)
+        registrar(LATENCIA_DISPLAY, i * 10);
+    uint32_t p50 = latencia_percentil(LATENCIA_DISPLAY, 500);
+    uint32_t p99 = latencia_percentil(LATENCIA_DISPLAY, 990);
+    uint32_t p100 = latencia_percentil(LATENCIA_DISPLAY, 1000);
+    verificar_perto(p50, 5000, 5, __LINE__);
+    verificar_perto(p99, 9900, 5, __LINE__);
+    VERIFICAR(p100 >= 10000 && p100 <= 10010);      // O máximo medido
+    VERIFICAR(latencia_percentil(LATENCIA_DISPLAY, 0) <= 20);
+    for (uint16_t q = 0; q < 1000; q += 10)
+        VERIFICAR(latencia_percentil(LATENCIA_DISPLAY, q) <= latencia_percentil(LATENCIA_DISPLAY, q + 10));
+
+    // Cauda longa: 98% perto de 300 us e 2% perto de 40 ms
+    for (uint32_t i = 0; i < 980; i++)
+        registrar(LATENCIA_MATRIZ, 290 + i % 20);
+    for (uint32_t i = 0; i < 20; i++)
+        registrar(LATENCIA_MATRIZ, 40000 + i * 10);
+    verificar_perto(latencia_percentil(LATENCIA_MATRIZ, 500), 300, 35, __LINE__);  // Faixa [256, 512)
+    VERIFICAR(latencia_percentil(LATENCIA_MATRIZ, 990) >= 32768);
+    VERIFICAR(latencia_percentil(LATENCIA_MATRIZ, 990) <= 40200);
+
+    // Acima da última faixa: o percentil não passa do máximo
+    registrar(LATENCIA_BUZZER, MAIOR_LATENCIA_US);
+    uint32_t p = latencia_percentil(LATENCIA_BUZZER, 990);
+    VERIFICAR(p >= 1u << (LATENCIA_FAIXAS - 1) && p <= MAIOR_LATENCIA_US + 10);
+
+    return teste_resultado("teste_latencia");
+}
@@ -0,0 +1,106 @@
+// Previsão de cruzamento: reprodução de um trace com rampa conhecida
+//
+// Um canal com limiares 500/800/900 sobe 10 décimos por segundo, primeiro com
+// leituras a cada 100 ms e depois a cada 1 s (entrada na economia). Na rampa a
+// regressão é exata: o tempo até o limiar é (limiar - valor) * 100 ms, e a
+// previsão começa quando ele cai abaixo do horizonte de 30 s. A troca do
+// intervalo recomeça a janela e descarta a previsão até a janela encher de
+// novo; o aviso se confirma no limiar e a rampa que para descarta a previsão
+// seguinte. Os contadores de previsao_stats conferem cada passo.
+
+#include "previsao.h"
+#include "teste.h"
+
+#define JANELA 10
+#define LIMIAR_AVISO 500
+
+static const alarme_canal_t canal = {
+    .nome = "rampa", .limiar = { 0, LIMIAR_AVISO, 800, 900 }, .histerese = 0, .margem = 0, .permanencia_ms = 0,
+};
+static const previsao_config_t config = { .janela = JANELA, .horizonte_s = 30 };
+
+static uint64_t t_us = 0;
+
+// Valor da rampa no instante atual: 10 décimos por segundo a partir de 100
+static int32_t rampa(void) {
+    return 100 + (int32_t)(t_us / 100000);
+}
+
+static previsao_t ler(int32_t y, uint32_t periodo_ms) {
+    alarme_avaliar(&y, t_us);
+    previsao_t p = previsao_atualizar(&y, 1, t_us);
+    t_us += periodo_ms * 1000u;
+    return p;
+}
+
+// Segundos até o limiar na rampa, arredondados para cima como em prever_canal
+static uint16_t segundos_ate(int32_t y, int32_t limiar) {
+    return (uint16_t)(((limiar - y) * 100 + 999) / 1000);
+}
+
+int main(void) {
+    alarme_init(&canal, 1);
+    previsao_init(0, &config);
+
+    // 100 ms: a janela enche na 10ª leitura, mas o limiar ainda está a mais de 30 s.
+    // A previsão começa em 200 (30 s) e conta os segundos até 500
+    for (int k = 0; k < 150; k++) {
+        int32_t y = rampa();
+        previsao_t p = ler(y, 100);
+        if (y < 200) {
+            VERIFICAR_IGUAL(p.nivel, ALARME_NORMAL);
+        } else {
+            VERIFICAR_IGUAL(p.nivel, ALARME_AVISO);
+            VERIFICAR_IGUAL(p.canal, 0);
+            VERIFICAR_IGUAL(p.segundos, segundos_ate(y, LIMIAR_AVISO));
+        }
+    }
+    previsao_stats_t s = previsao_stats();
+    VERIFICAR_IGUAL(s.emitidas, 1);
+    VERIFICAR_IGUAL(s.descartadas, 0);
+
+    // 1 s: a primeira leitura recomeça a janela e a previsão é descartada; ela
+    // volta quando a janela enche outra vez, ainda com o tempo exato
+    t_us += 900000;
+    for (int j = 0; j < JANELA - 1; j++) {
+        previsao_t p = ler(rampa(), 1000);
+        VERIFICAR_IGUAL(p.nivel, ALARME_NORMAL);
+    }
+    s = previsao_stats();
+    VERIFICAR_IGUAL(s.emitidas, 1);
+    VERIFICAR_IGUAL(s.descartadas, 1);
+
+    uint64_t inicio_us = t_us;
+    int32_t y;
+    previsao_t p;
+    while ((y = rampa()) < LIMIAR_AVISO) {
+        p = ler(y, 1000);
+        VERIFICAR_IGUAL(p.nivel, ALARME_AVISO);
+        VERIFICAR_IGUAL(p.segundos, segundos_ate(y, LIMIAR_AVISO));
+    }
+    VERIFICAR_IGUAL(previsao_stats().emitidas, 2);
+
+    // No limiar o aviso se confirma, com a antecedência desde o início da segunda
+    // previsão, e a mesma rampa já prevê o alerta (800 a menos de 30 s)
+    uint64_t confirmacao_us = t_us;
+    p = ler(y, 1000);
+    VERIFICAR_IGUAL(alarme_nivel_atual(), ALARME_AVISO);
+    VERIFICAR_IGUAL(p.nivel, ALARME_ALERTA);
+    s = previsao_stats();
+    VERIFICAR_IGUAL(s.confirmadas, 1);
+    VERIFICAR_IGUAL(s.emitidas, 3);
+    VERIFICAR_IGUAL(s.antecedencia_min_ms, (confirmacao_us - inicio_us) / 1000);
+    VERIFICAR_IGUAL(s.antecedencia_max_ms, (confirmacao_us - inicio_us) / 1000);
+    VERIFICAR_IGUAL(s.antecedencia_media_ms, (confirmacao_us - inicio_us) / 1000);
+
+    // A rampa para: com a janela plana a previsão do alerta é descartada
+    for (int j = 0; j < JANELA; j++)
+        p = ler(y, 1000);
+    VERIFICAR_IGUAL(p.nivel, ALARME_NORMAL);
+    s = previsao_stats();
+    VERIFICAR_IGUAL(s.emitidas, 3);
+    VERIFICAR_IGUAL(s.confirmadas, 1);
+    VERIFICAR_IGUAL(s.descartadas, 2);
+
+    return teste_resultado("teste_previsao");
+}
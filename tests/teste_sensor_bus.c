@@ -0,0 +1,149 @@
+// Barramento das amostras: cada assinante vê cada amostra, nos três modos, e
+// os assinantes que não leem descartam pela regra do seu modo
+//
+// Três consumidores (caixa de correio, histórico e anel) leem em tarefas
+// próprias e confirmam cada amostra ao produtor, que só publica a seguinte
+// depois das três confirmações. Outros três assinantes não são lidos durante
+// a publicação e são conferidos no fim: a caixa guarda a última amostra, o
+// histórico as últimas N e o anel as primeiras (a nova é descartada).
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "sensor_bus.h"
+#include "teste.h"
+
+#define NUM_AMOSTRAS 100
+#define NUM_CONSUMIDORES 3
+#define ESPERA pdMS_TO_TICKS(1000)
+#define LATENCIA_MAX_US 100000      // Folga para a porta POSIX em uma máquina carregada
+
+typedef struct {
+    const char *nome;
+    sensor_bus_sub_t *sub;
+    uint32_t recebidas;
+    uint32_t fora_de_ordem;         // seq diferente da publicada
+    uint32_t valores_errados;       // Conteúdo diferente do publicado para a seq
+    uint64_t latencia_total_us;
+    uint64_t latencia_max_us;
+} consumidor_t;
+
+static consumidor_t consumidores[NUM_CONSUMIDORES] = {
+    { .nome = "caixa" }, { .nome = "historico" }, { .nome = "anel" },
+};
+static sensor_bus_sub_t *caixa_parada, *historico_parado, *anel_parado;
+static TaskHandle_t produtor;
+
+static void preencher(sensor_amostra_t *a, uint32_t n) {
+    for (int c = 0; c < CANAIS_MAX; c++) {
+        a->valores[c] = (int32_t)(n * 10 + c) - 500;
+        a->tendencias[c] = -(int32_t)n;
+    }
+}
+
+static bool confere(const sensor_amostra_t *a) {
+    for (int c = 0; c < CANAIS_MAX; c++) {
+        if (a->valores[c] != (int32_t)(a->seq * 10 + c) - 500 || a->tendencias[c] != -(int32_t)a->seq)
+            return false;
+    }
+    return true;
+}
+
+static void consumir(void *param) {
+    consumidor_t *c = param;
+    sensor_amostra_t a;
+    while (c->recebidas < NUM_AMOSTRAS && sensor_bus_receive(c->sub, &a, ESPERA)) {
+        uint64_t latencia = time_us_64() - a.timestamp_us;
+        c->latencia_total_us += latencia;
+        if (latencia > c->latencia_max_us)
+            c->latencia_max_us = latencia;
+        if (a.seq != c->recebidas)
+            c->fora_de_ordem++;
+        if (!confere(&a))
+            c->valores_errados++;
+        c->recebidas++;
+        xTaskNotifyGive(produtor);
+    }
+    vTaskSuspend(NULL);
+}
+
+static void conferir_parados(void) {
+    sensor_amostra_t a;
+
+    // Caixa de correio: só a mais recente, sem contar descartes
+    VERIFICAR(sensor_bus_receive(caixa_parada, &a, 0));
+    VERIFICAR_IGUAL(a.seq, NUM_AMOSTRAS - 1);
+    VERIFICAR(!sensor_bus_receive(caixa_parada, &a, 0));
+
+    // Histórico de 4: as 4 últimas, em ordem, e as demais contadas como descartadas
+    VERIFICAR_IGUAL(historico_parado->descartadas, NUM_AMOSTRAS - 4);
+    for (uint32_t s = NUM_AMOSTRAS - 4; s < NUM_AMOSTRAS; s++) {
+        VERIFICAR(sensor_bus_receive(historico_parado, &a, 0));
+        VERIFICAR_IGUAL(a.seq, s);
+        VERIFICAR(confere(&a));
+    }
+    VERIFICAR(!sensor_bus_receive(historico_parado, &a, 0));
+
+    // Anel pedido com 3, arredondado para 4: as 4 primeiras ficam, as novas se perdem
+    VERIFICAR_IGUAL(anel_parado->descartadas, NUM_AMOSTRAS - 4);
+    for (uint32_t s = 0; s < 4; s++) {
+        VERIFICAR(sensor_bus_receive(anel_parado, &a, 0));
+        VERIFICAR_IGUAL(a.seq, s);
+        VERIFICAR(confere(&a));
+    }
+    VERIFICAR(!sensor_bus_receive(anel_parado, &a, 0));
+}
+
+static void produzir(void *param) {
+    (void)param;
+    for (uint32_t n = 0; n < NUM_AMOSTRAS; n++) {
+        sensor_amostra_t a;
+        preencher(&a, n);
+        a.timestamp_us = time_us_64();
+        sensor_bus_publish(&a);
+
+        uint32_t confirmadas = 0;
+        while (confirmadas < NUM_CONSUMIDORES && ulTaskNotifyTake(pdFALSE, ESPERA))
+            confirmadas++;
+        VERIFICAR_IGUAL(confirmadas, NUM_CONSUMIDORES);
+        if (confirmadas < NUM_CONSUMIDORES)
+            break;
+    }
+
+    for (int i = 0; i < NUM_CONSUMIDORES; i++) {
+        consumidor_t *c = &consumidores[i];
+        VERIFICAR_IGUAL(c->recebidas, NUM_AMOSTRAS);
+        VERIFICAR_IGUAL(c->fora_de_ordem, 0);
+        VERIFICAR_IGUAL(c->valores_errados, 0);
+        VERIFICAR_IGUAL(c->sub->descartadas, 0);
+        VERIFICAR(c->latencia_max_us < LATENCIA_MAX_US);
+        printf("latencia,%s,%u,%llu,%llu\n", c->nome, (unsigned)c->recebidas,
+               (unsigned long long)(c->recebidas ? c->latencia_total_us / c->recebidas : 0),
+               (unsigned long long)c->latencia_max_us);
+    }
+    conferir_parados();
+    exit(teste_resultado("teste_sensor_bus"));
+}
+
+int main(void) {
+    consumidores[0].sub = sensor_bus_subscribe(SENSOR_BUS_MAILBOX, 1);
+    consumidores[1].sub = sensor_bus_subscribe(SENSOR_BUS_HISTORY, 4);
+    consumidores[2].sub = sensor_bus_subscribe(SENSOR_BUS_RING, 8);
+    caixa_parada = sensor_bus_subscribe(SENSOR_BUS_MAILBOX, 1);
+    historico_parado = sensor_bus_subscribe(SENSOR_BUS_HISTORY, 4);
+    anel_parado = sensor_bus_subscribe(SENSOR_BUS_RING, 3);
+    for (int i = 0; i < NUM_CONSUMIDORES; i++)
+        VERIFICAR(consumidores[i].sub != NULL);
+    VERIFICAR(caixa_parada && historico_parado && anel_parado);
+
+    // 22 das 32 amostras da reserva em uso: um histórico de 16 não cabe mais
+    VERIFICAR(sensor_bus_subscribe(SENSOR_BUS_HISTORY, 16) == NULL);
+    if (teste_falhas)
+        return teste_resultado("teste_sensor_bus");
+
+    // Consumidores acima do produtor: com um núcleo, cada publicação os acorda na hora
+    xTaskCreate(produzir, "Produtor", configMINIMAL_STACK_SIZE * 4, NULL, tskIDLE_PRIORITY + 1, &produtor);
+    for (int i = 0; i < NUM_CONSUMIDORES; i++)
+        xTaskCreate(consumir, consumidores[i].nome, configMINIMAL_STACK_SIZE * 4, &consumidores[i], tskIDLE_PRIORITY + 2, NULL);
+    vTaskStartScheduler();
+    return 1;
+}
@@ -0,0 +1,60 @@
+# Serial da simulação de ponta a ponta: comandos pela entrada padrão do EstacaoSim
+#
+# O firmware inteiro roda com a entrada padrão ligada a um arquivo, e os
+# caracteres passam pelo laço de getchar_timeout_us da tarefa de instrumentação
+# (DispFilaTasks.c), como os da USB CDC na placa. Confere que uma linha de
+# configuração tem precedência sobre 's' e 'h' (":ler chuva.histerese" não pede
+# retrato nem despejo), que 's' e 'h' soltos ainda funcionam e que um :gravar
+# vale na partida seguinte, sobre a mesma flash.
+#
+# Uso: cmake -DSIM=<EstacaoSim> -DSAIDA=<diretório> -P teste_serial.cmake
+
+file(REMOVE_RECURSE ${SAIDA})
+file(MAKE_DIRECTORY ${SAIDA})
+set(ENV{ESTACAO_SIM_DIR} ${SAIDA})
+set(ENV{ESTACAO_SIM_DURACAO_MS} 2000)
+
+# Roda a simulação com 'comandos' na entrada padrão e guarda a saída em 'var'
+function(executar nome comandos var)
+    file(WRITE ${SAIDA}/${nome}.txt "${comandos}")
+    execute_process(COMMAND ${SIM}
+            INPUT_FILE ${SAIDA}/${nome}.txt
+            OUTPUT_VARIABLE saida
+            RESULT_VARIABLE rc
+            TIMEOUT 30)
+    if (NOT rc EQUAL 0)
+        message(SEND_ERROR "${nome}: a simulação terminou com ${rc}")
+    endif ()
+    set(${var} "${saida}" PARENT_SCOPE)
+endfunction()
+
+# A saída contém o trecho
+function(esperar saida trecho)
+    string(FIND "${saida}" "${trecho}" pos)
+    if (pos EQUAL -1)
+        message(SEND_ERROR "esperado na serial: ${trecho}")
+    endif ()
+endfunction()
+
+# O padrão aparece exatamente 'n' vezes
+function(contar saida padrao n)
+    string(REGEX MATCHALL "${padrao}" achados "${saida}")
+    list(LENGTH achados total)
+    if (NOT total EQUAL n)
+        message(SEND_ERROR "'${padrao}' apareceu ${total} vez(es) na serial, esperado ${n}")
+    endif ()
+endfunction()
+
+executar(partida1 ":ler chuva.histerese\nh\ns\n:ajustar periodo_ms=200 chuva.histerese=3\n:ler periodo_ms\n:gravar\n" saida)
+esperar("${saida}" "config,chuva.histerese,2.4\n# config,ok,1,padrao\n")
+esperar("${saida}" "# config,ok,2\n")
+esperar("${saida}" "config,periodo_ms,200\n# config,ok,1,alterada\n")
+esperar("${saida}" "# config,ok,gravada,")
+contar("${saida}" "# historico," 1)
+contar("${saida}" "# instr," 1)
+
+executar(partida2 ":ler periodo_ms\n:ler chuva.histerese\n" saida)
+esperar("${saida}" "config,periodo_ms,200\n# config,ok,1,flash\n")
+esperar("${saida}" "config,chuva.histerese,3.0\n")
+contar("${saida}" "# historico," 0)
+contar("${saida}" "# instr," 0)
@@ -0,0 +1,108 @@
+// Envio ao display: bytes no barramento por atualização completa e parcial
+//
+// O I2C simulado (host/hal_i2c.c) interpreta o tráfego como um SSD1306. Cada
+// página alterada custa uma transação de comando (7 bytes) e uma de dados
+// (1 + colunas da janela); depois de cada envio a GDDRAM do modelo deve ser
+// igual ao ram_buffer.
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "ssd1306.h"
+#include "hal_host.h"
+#include "teste.h"
+
+#define COMANDO 7                   // 0x00, coluna inicial/final, página inicial/final
+#define PAGINA(colunas) (COMANDO + 1 + (colunas))
+
+static ssd1306_t ssd;
+
+// GDDRAM do modelo igual ao ram_buffer (endereçamento vertical: x * páginas + página)
+static bool gddram_confere(void) {
+    const uint8_t *g = host_i2c_gddram();
+    for (uint8_t p = 0; p < ssd.pages; p++)
+        for (uint8_t x = 0; x < ssd.width; x++)
+            if (g[p * WIDTH + x] != ssd.ram_buffer[1 + x * ssd.pages + p])
+                return false;
+    return true;
+}
+
+// Envia e confere os bytes vistos no barramento e os contados pelo driver
+static void enviar(bool assincrono, uint32_t esperado, int linha) {
+    uint64_t antes = host_i2c_bytes();
+    uint32_t contados = ssd.bytes_sent;
+    if (assincrono) {
+        ssd1306_send_data_async(&ssd);
+        ssd1306_wait(&ssd);
+    } else {
+        ssd1306_send_data(&ssd);
+    }
+    uint64_t barramento = host_i2c_bytes() - antes;
+    if (barramento != esperado || ssd.bytes_sent - contados != esperado || !gddram_confere()) {
+        fprintf(stderr, "linha %d: %llu bytes no barramento, %u contados, esperado %u%s\n", linha,
+                (unsigned long long)barramento, (unsigned)(ssd.bytes_sent - contados), (unsigned)esperado,
+                gddram_confere() ? "" : ", GDDRAM diferente");
+        teste_falhas++;
+    }
+}
+
+static void sequencia(bool assincrono) {
+    // Conteúdo desconhecido: o primeiro envio é completo, mesmo com o quadro apagado
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c0);
+    ssd1306_config(&ssd);
+    enviar(assincrono, 8 * PAGINA(WIDTH), __LINE__);
+
+    // Nada mudou
+    enviar(assincrono, 0, __LINE__);
+
+    // Um pixel: uma coluna de uma página
+    ssd1306_pixel(&ssd, 10, 20, true);
+    enviar(assincrono, PAGINA(1), __LINE__);
+
+    // Linha de 36 colunas na página 0
+    ssd1306_hline(&ssd, 5, 40, 3, true);
+    enviar(assincrono, PAGINA(36), __LINE__);
+
+    // Redesenho idêntico: marcado como sujo, mas a comparação descarta tudo
+    ssd1306_hline(&ssd, 5, 40, 3, true);
+    ssd1306_mark_dirty(&ssd, 0, 0, WIDTH - 1, HEIGHT - 1);
+    enviar(assincrono, 0, __LINE__);
+
+    // Nenhuma coluna copiada: a página continua limpa, sem comparação no envio
+    static const uint8_t vazio = 0xFF;
+    ssd1306_blit_columns(&ssd, &vazio, 0, 0, 8);
+    VERIFICAR(ssd.dirty_x0[1] > ssd.dirty_x1[1]);
+    enviar(assincrono, 0, __LINE__);
+
+    // Duas colunas distantes na mesma página: uma janela só, das duas pontas
+    ssd1306_pixel(&ssd, 5, 4, true);
+    ssd1306_pixel(&ssd, 40, 4, true);
+    enviar(assincrono, PAGINA(36), __LINE__);
+
+    // Coluna apagada dentro de uma faixa marcada: a janela encolhe até ela
+    ssd1306_mark_dirty(&ssd, 0, 0, WIDTH - 1, 7);
+    ssd1306_pixel(&ssd, 20, 3, false);
+    enviar(assincrono, PAGINA(1), __LINE__);
+
+    // Retângulo que cruza as páginas 1 a 3, 10 colunas
+    ssd1306_rect(&ssd, 12, 60, 10, 14, true, true);
+    enviar(assincrono, 3 * PAGINA(10), __LINE__);
+
+    // Quadro inteiro invertido
+    ssd1306_fill(&ssd, true);
+    enviar(assincrono, 8 * PAGINA(WIDTH), __LINE__);
+
+    // NACK: o controlador descartou o FIFO e o próximo envio é completo
+    i2c0->hw.tx_abrt_source = 1;
+    ssd1306_wait(&ssd);
+    i2c0->hw.tx_abrt_source = 0;
+    ssd1306_pixel(&ssd, 0, 0, false);
+    enviar(assincrono, 8 * PAGINA(WIDTH), __LINE__);
+    enviar(assincrono, 0, __LINE__);
+}
+
+int main(void) {
+    sequencia(false);
+    sequencia(true);
+    return teste_resultado("teste_ssd1306");
+}
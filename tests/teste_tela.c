@@ -0,0 +1,112 @@
+// Tela da estação: quadros de referência (tests/golden/*.pbm)
+//
+// Uma sequência fixa de leituras passa pelos alarmes e pela tela, com os
+// instantes dados pelo teste, e em pontos escolhidos a GDDRAM do modelo do
+// SSD1306 (host/hal_i2c.c) é gravada em PBM e comparada byte a byte com a
+// referência. Com ESTACAO_GOLDEN_ATUALIZAR=1 o teste regrava as referências em
+// vez de compará-las; o quadro obtido fica sempre no diretório de saída.
+
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "ssd1306.h"
+#include "canais.h"
+#include "canais_estacao.h"
+#include "tela.h"
+#include "hal_host.h"
+#include "teste.h"
+
+#define PERIODO_US 100000           // Leituras a 10 Hz, como na estação
+#define TAMANHO_PBM (WIDTH / 8 * HEIGHT)
+
+static ssd1306_t ssd;
+static uint64_t t_us = 0;
+static uint32_t seq = 0;
+
+// Lê um arquivo inteiro (referências têm poucos KB)
+static size_t ler_arquivo(const char *caminho, uint8_t *buf, size_t max) {
+    FILE *f = fopen(caminho, "rb");
+    if (!f)
+        return 0;
+    size_t n = fread(buf, 1, max, f);
+    fclose(f);
+    return n;
+}
+
+// Grava a GDDRAM atual e a compara com tests/golden/<nome>.pbm
+static void comparar(const char *nome) {
+    char arquivo[64], golden[512];
+    snprintf(arquivo, sizeof(arquivo), "%s.pbm", nome);
+    snprintf(golden, sizeof(golden), "%s/%s", ESTACAO_GOLDEN_DIR, arquivo);
+    const char *obtido = teste_caminho(arquivo);
+    VERIFICAR(host_i2c_pbm(obtido));
+
+    const char *atualizar = getenv("ESTACAO_GOLDEN_ATUALIZAR");
+    if (atualizar && *atualizar == '1') {
+        VERIFICAR(host_i2c_pbm(golden));
+        printf("%s: referência regravada\n", golden);
+        return;
+    }
+
+    static uint8_t a[TAMANHO_PBM + 64], b[TAMANHO_PBM + 64];
+    size_t na = ler_arquivo(obtido, a, sizeof(a));
+    size_t nb = ler_arquivo(golden, b, sizeof(b));
+    if (nb == 0) {
+        fprintf(stderr, "%s: referência ausente\n", golden);
+        teste_falhas++;
+        return;
+    }
+    if (na != nb || memcmp(a, b, na) != 0) {
+        uint32_t pixels = 0;
+        for (size_t i = 0; i < na && i < nb; i++)
+            pixels += __builtin_popcount(a[i] ^ b[i]);
+        fprintf(stderr, "%s: diferente da referência (%u pixels; obtido em %s)\n", nome, (unsigned)pixels, obtido);
+        teste_falhas++;
+    }
+}
+
+// Uma leitura pela mesma cadeia da tarefa do display, sem o filtro
+static void ler(int32_t chuva, int32_t nivel, int32_t temperatura, int32_t pluviometro) {
+    sensor_amostra_t a = { .seq = seq++, .timestamp_us = t_us,
+                           .valores = { chuva, nivel, temperatura, pluviometro } };
+    alarme_avaliar(a.valores, a.timestamp_us);
+    tela_atualizar(&a);
+    if (tela_desenhar())
+        ssd1306_send_data(&ssd);
+    t_us += PERIODO_US;
+}
+
+int main(void) {
+    canais_init(canais_estacao, canais_estacao_num);
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c1);
+    ssd1306_config(&ssd);
+    tela_init(&ssd);
+
+    // Normal: uma rampa da chuva e um triângulo do nível, mais de 128 pontos para
+    // o gráfico rolar. Termina em 72 s, no grupo da chuva e do nível
+    for (int32_t k = 0; k < 720; k++) {
+        int32_t tri = k % 200 < 100 ? k % 200 : 200 - k % 200;
+        ler(100 + k * 600 / 720, 150 + tri * 4, 251, 0);
+    }
+    comparar("tela_normal");
+
+    // Três segundos depois, o segundo grupo (temperatura e pluviômetro)
+    for (int k = 0; k < 30; k++)
+        ler(700, 550, 253, 120);
+    comparar("tela_grupo2");
+
+    // Previsão de alerta sem alarme: contagem regressiva na faixa
+    alarme_prever(ALARME_ALERTA, 12, t_us);
+    ler(720, 560, 253, 120);
+    comparar("tela_previsao");
+
+    // Pluviômetro crítico por mais que a permanência: alerta no grupo dele
+    alarme_prever(ALARME_NORMAL, 0, t_us);
+    for (int k = 0; k < 10; k++)
+        ler(720, 560, 253, 850);
+    VERIFICAR_IGUAL(alarme_nivel_atual(), ALARME_CRITICO);
+    comparar("tela_critico");
+
+    return teste_resultado("teste_tela");
+}
@@ -0,0 +1,147 @@
+# Gera o atlas da fonte em colunas a partir de lib/font.h
+#
+# Uso: cmake -DINPUT=lib/font.h -DOUTPUT=font_atlas.h -P tools/font_atlas.cmake
+#
+# A fonte original guarda cada glifo por linhas (byte i = linha i, bit j = coluna j).
+# O display usa páginas verticais, então o atlas gerado guarda cada glifo por
+# colunas (byte j = coluna j, bit i = linha i), pronto para cópia direta no
+# ram_buffer. Também são gerados a largura proporcional de cada glifo, a versão
+# ampliada 2x (duas páginas por coluna) e a tabela de conversão de caracteres.
+
+if(NOT INPUT OR NOT OUTPUT)
+    message(FATAL_ERROR "font_atlas.cmake: defina INPUT e OUTPUT")
+endif()
+
+# Os comentários da fonte contêm ';', '[' e ']', que quebrariam as listas do
+# CMake: cada glifo é reduzido aos seus bytes antes de virar item de lista
+file(READ ${INPUT} conteudo)
+string(REGEX REPLACE "//[^\n]*" "" conteudo "${conteudo}")
+string(REGEX MATCHALL "{[ \t]*0x[^}]*}" linhas "${conteudo}")
+list(LENGTH linhas num_glifos)
+
+set(cols_1x "")
+set(cols_2x "")
+set(offsets "")
+set(larguras "")
+set(glifo 0)
+
+foreach(linha IN LISTS linhas)
+    string(REGEX MATCHALL "0x[0-9A-Fa-f][0-9A-Fa-f]" r "${linha}")
+    list(LENGTH r n)
+    if(NOT n EQUAL 8)
+        message(FATAL_ERROR "font_atlas.cmake: glifo ${glifo} com ${n} linhas")
+    endif()
+    list(GET r 0 r0)
+    list(GET r 1 r1)
+    list(GET r 2 r2)
+    list(GET r 3 r3)
+    list(GET r 4 r4)
+    list(GET r 5 r5)
+    list(GET r 6 r6)
+    list(GET r 7 r7)
+
+    # Transposição: coluna j reúne o bit j de cada linha
+    set(c1 "")
+    set(c2_lo "")
+    set(c2_hi "")
+    set(primeira -1)
+    set(ultima -1)
+    foreach(j RANGE 7)
+        math(EXPR col "((${r0} >> ${j}) & 1) | (((${r1} >> ${j}) & 1) << 1) | (((${r2} >> ${j}) & 1) << 2) | (((${r3} >> ${j}) & 1) << 3) | (((${r4} >> ${j}) & 1) << 4) | (((${r5} >> ${j}) & 1) << 5) | (((${r6} >> ${j}) & 1) << 6) | (((${r7} >> ${j}) & 1) << 7)")
+        math(EXPR hex "${col}" OUTPUT_FORMAT HEXADECIMAL)
+        string(APPEND c1 "${hex}, ")
+        if(NOT col EQUAL 0)
+            if(primeira LESS 0)
+                set(primeira ${j})
+            endif()
+            set(ultima ${j})
+        endif()
+
+        # Ampliação 2x: cada bit vira dois bits (vertical) e cada coluna vira duas (horizontal)
+        math(EXPR lo "((${col} & 1) * 3) | (((${col} >> 1) & 1) * 12) | (((${col} >> 2) & 1) * 48) | (((${col} >> 3) & 1) * 192)" OUTPUT_FORMAT HEXADECIMAL)
+        math(EXPR hi "(((${col} >> 4) & 1) * 3) | (((${col} >> 5) & 1) * 12) | (((${col} >> 6) & 1) * 48) | (((${col} >> 7) & 1) * 192)" OUTPUT_FORMAT HEXADECIMAL)
+        string(APPEND c2_lo "${lo}, ${lo}, ")
+        string(APPEND c2_hi "${hi}, ${hi}, ")
+    endforeach()
+
+    # Largura proporcional: colunas ocupadas; glifos vazios (espaço) ficam com 3 colunas
+    if(primeira LESS 0)
+        set(primeira 0)
+        set(largura 3)
+    else()
+        math(EXPR largura "${ultima} - ${primeira} + 1")
+    endif()
+
+    string(REGEX REPLACE ", $" "" c1 "${c1}")
+    string(REGEX REPLACE ", $" "" c2_lo "${c2_lo}")
+    string(REGEX REPLACE ", $" "" c2_hi "${c2_hi}")
+    string(APPEND cols_1x "    { ${c1} },   // ${glifo}\n")
+    string(APPEND cols_2x "    {{ ${c2_lo} },\n     { ${c2_hi} }},\n")
+    string(APPEND offsets "${primeira}, ")
+    string(APPEND larguras "${largura}, ")
+    math(EXPR glifo "${glifo} + 1")
+endforeach()
+
+# Conversão de caractere para glifo, equivalente à que o driver fazia em tempo de
+# execução: 135 (segundo byte de 'Ç' em UTF-8) vira o glifo 127 e o restante acima
+# do fim da fonte vira o glifo vazio 0
+set(indices "")
+foreach(c RANGE 255)
+    if(c EQUAL 135)
+        set(i 127)
+    elseif(c GREATER_EQUAL num_glifos)
+        set(i 0)
+    else()
+        set(i ${c})
+    endif()
+    string(APPEND indices "${i}, ")
+    math(EXPR resto "(${c} + 1) % 16")
+    if(resto EQUAL 0)
+        string(APPEND indices "\n    ")
+    endif()
+endforeach()
+string(REGEX REPLACE ",? *\n    $" "" indices "${indices}")
+
+file(WRITE ${OUTPUT}.tmp
+"// Arquivo gerado por tools/font_atlas.cmake a partir de lib/font.h - não editar\n"
+"#ifndef FONT_ATLAS_H\n"
+"#define FONT_ATLAS_H\n"
+"\n"
+"#include <stdint.h>\n"
+"\n"
+"#define FONT_ATLAS_GLYPHS ${num_glifos}\n"
+"\n"
+"// Índice do glifo para cada valor de caractere\n"
+"static const uint8_t font_index[256] = {\n"
+"    ${indices}\n"
+"};\n"
+"\n"
+"// Glifos 8x8 por colunas: byte j = coluna j, bit i = linha i\n"
+"static const uint8_t font_cols[FONT_ATLAS_GLYPHS][8] = {\n"
+"${cols_1x}"
+"};\n"
+"\n"
+"// Primeira coluna ocupada e largura de cada glifo para texto proporcional\n"
+"static const uint8_t font_offset[FONT_ATLAS_GLYPHS] = { ${offsets}};\n"
+"static const uint8_t font_width[FONT_ATLAS_GLYPHS] = { ${larguras}};\n"
+"\n"
+"// Glifos ampliados 2x (16x16): [página][coluna]\n"
+"static const uint8_t font_cols_2x[FONT_ATLAS_GLYPHS][2][16] = {\n"
+"${cols_2x}"
+"};\n"
+"\n"
+"#endif // FONT_ATLAS_H\n"
+)
+
+# Só substitui o arquivo se mudou, para não forçar recompilação
+file(READ ${OUTPUT}.tmp novo)
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} atual)
+else()
+    set(atual "")
+endif()
+if(NOT novo STREQUAL atual)
+    file(RENAME ${OUTPUT}.tmp ${OUTPUT})
+else()
+    file(REMOVE ${OUTPUT}.tmp)
+endif()
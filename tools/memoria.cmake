@@ -0,0 +1,135 @@
+# Relatório de RAM por subsistema a partir do mapa de ligação do firmware
+#
+# Uso: cmake -DMAPA=PiscaLed.elf.map -DSAIDA=PiscaLed.memoria.txt -P tools/memoria.cmake
+#
+# Soma as seções de entrada cujo endereço cai na RAM do RP2040 (SRAM e os
+# bancos SCRATCH_X/Y), agrupadas pelo arquivo de objeto que as definiu: cada
+# módulo de lib/ vira uma linha, o kernel do FreeRTOS, o TinyUSB, o pico-sdk e
+# a libc aparecem agrupados. A reserva de pilha dos núcleos e o heap da libc
+# (seções .stack e .heap do crt0) aparecem separados. Em seguida vêm as maiores
+# seções, que mostram onde cada subsistema gasta.
+
+if(NOT MAPA OR NOT SAIDA)
+    message(FATAL_ERROR "memoria.cmake: defina MAPA e SAIDA")
+endif()
+if(NOT RAM_INICIO)
+    set(RAM_INICIO 0x20000000)
+endif()
+if(NOT RAM_FIM)
+    set(RAM_FIM 0x20042000)
+endif()
+if(NOT MAIORES)
+    set(MAIORES 15)
+endif()
+math(EXPR ram_inicio "${RAM_INICIO}")
+math(EXPR ram_fim "${RAM_FIM}")
+
+# Completa com zeros à esquerda, para ordenar os tamanhos como texto
+function(alinhar valor largura saida)
+    string(LENGTH "${valor}" n)
+    set(s "${valor}")
+    while(n LESS largura)
+        set(s "0${s}")
+        math(EXPR n "${n} + 1")
+    endwhile()
+    set(${saida} "${s}" PARENT_SCOPE)
+endfunction()
+
+# Nome do subsistema dono de uma seção
+function(subsistema secao objeto saida)
+    if(secao MATCHES "^\\.heap")
+        set(nome "heap da libc")
+    elseif(secao MATCHES "^\\.stack")
+        set(nome "pilhas dos nucleos")
+    elseif(objeto MATCHES "FreeRTOS-Kernel")
+        set(nome "FreeRTOS")
+    elseif(objeto MATCHES "tinyusb")
+        set(nome "tinyusb")
+    elseif(objeto MATCHES "pico-sdk|pico_sdk|/crt0")
+        set(nome "pico-sdk")
+    elseif(objeto MATCHES "lib([^/(]+)\\.a\\(")
+        set(nome "${CMAKE_MATCH_1}")
+    else()
+        get_filename_component(nome "${objeto}" NAME)
+        string(REGEX REPLACE "\\.(c|S|cpp)?\\.?(obj|o)$" "" nome "${nome}")
+    endif()
+    set(${saida} "${nome}" PARENT_SCOPE)
+endfunction()
+
+file(STRINGS ${MAPA} linhas)
+
+set(nomes "")
+set(secoes "")
+set(total 0)
+set(pendente "")
+foreach(linha IN LISTS linhas)
+    # Seção de entrada: " .bss.x  0xENDERECO  0xTAMANHO objeto", quebrada em
+    # duas linhas quando o nome é longo
+    set(secao "")
+    if(linha MATCHES "^ ([.A-Za-z_][^ ]*|COMMON) +0x([0-9a-fA-F]+) +0x([0-9a-fA-F]+) +(.+)$")
+        set(secao "${CMAKE_MATCH_1}")
+        set(endereco "0x${CMAKE_MATCH_2}")
+        set(tamanho "0x${CMAKE_MATCH_3}")
+        set(objeto "${CMAKE_MATCH_4}")
+    elseif(pendente AND linha MATCHES "^ +0x([0-9a-fA-F]+) +0x([0-9a-fA-F]+) +(.+)$")
+        set(secao "${pendente}")
+        set(endereco "0x${CMAKE_MATCH_1}")
+        set(tamanho "0x${CMAKE_MATCH_2}")
+        set(objeto "${CMAKE_MATCH_3}")
+    endif()
+    set(pendente "")
+    if(linha MATCHES "^ ([.A-Za-z_][^ ]*|COMMON)$")
+        set(pendente "${CMAKE_MATCH_1}")
+    endif()
+    if(NOT secao OR secao STREQUAL "*fill*")
+        continue()
+    endif()
+
+    math(EXPR endereco "${endereco}")
+    math(EXPR tamanho "${tamanho}")
+    if(tamanho EQUAL 0 OR endereco LESS ram_inicio OR NOT endereco LESS ram_fim)
+        continue()
+    endif()
+
+    subsistema("${secao}" "${objeto}" nome)
+    string(MAKE_C_IDENTIFIER "${nome}" id)
+    if(NOT DEFINED soma_${id})
+        set(soma_${id} 0)
+        list(APPEND nomes "${nome}")
+    endif()
+    math(EXPR soma_${id} "${soma_${id}} + ${tamanho}")
+    math(EXPR total "${total} + ${tamanho}")
+
+    alinhar(${tamanho} 8 chave)
+    list(APPEND secoes "${chave} ${secao} (${nome})")
+endforeach()
+
+set(por_subsistema "")
+foreach(nome IN LISTS nomes)
+    string(MAKE_C_IDENTIFIER "${nome}" id)
+    alinhar(${soma_${id}} 8 chave)
+    list(APPEND por_subsistema "${chave} ${nome}")
+endforeach()
+list(SORT por_subsistema)
+list(REVERSE por_subsistema)
+list(SORT secoes)
+list(REVERSE secoes)
+
+set(texto "RAM por subsistema (bytes)\n")
+foreach(item IN LISTS por_subsistema)
+    string(REGEX MATCH "^0*([0-9]+) (.*)$" _ "${item}")
+    string(APPEND texto "  ${CMAKE_MATCH_1}\t${CMAKE_MATCH_2}\n")
+endforeach()
+string(APPEND texto "  ${total}\ttotal\n\nMaiores secoes\n")
+set(i 0)
+foreach(item IN LISTS secoes)
+    if(NOT i LESS MAIORES)
+        break()
+    endif()
+    string(REGEX MATCH "^0*([0-9]+) (.*)$" _ "${item}")
+    string(APPEND texto "  ${CMAKE_MATCH_1}\t${CMAKE_MATCH_2}\n")
+    math(EXPR i "${i} + 1")
+endforeach()
+
+file(WRITE ${SAIDA} "${texto}")
+message("${texto}")
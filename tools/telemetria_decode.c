@@ -0,0 +1,79 @@
+// Decodificador da telemetria binária do firmware (lib/telemetria.c)
+//
+// Lê o fluxo da serial (arquivo ou stdin), separa os quadros pelos bytes 0x00,
+// confere COBS e CRC e imprime um CSV por tipo de registro:
+//   amostra,<seq>,<t_us>,<nivel>,<canal 0>,<canal 1>,...
+//   alarme,<seq>,<t_us>,<nivel>,<anterior>
+// Texto misturado ao fluxo (printf do firmware) é descartado como quadro
+// inválido. No fim, o resumo com quadros válidos, inválidos e registros
+// perdidos (saltos no seq) vai para stderr.
+//
+// Uso: telemetria_decode [serial.bin] > telemetria.csv
+
+#include "enquadramento.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_BRUTO 256               // Quadros maiores que isso certamente não são telemetria
+
+static unsigned long validos = 0, invalidos = 0, perdidos = 0;
+static bool primeiro = true;
+static uint16_t seq_esperado = 0;
+
+static void imprimir(const enq_registro_t *r) {
+    if (!primeiro)
+        perdidos += (uint16_t)(r->seq - seq_esperado);
+    primeiro = false;
+    seq_esperado = r->seq + 1;
+
+    const uint8_t *d = r->dados;
+    if (r->tipo == ENQ_AMOSTRA && r->tam >= 1) {
+        printf("amostra,%u,%lu,%u", r->seq, (unsigned long)r->t_us, d[0]);
+        for (uint8_t i = 1; i + 1 < r->tam; i += 2) {
+            int v = (int16_t)(d[i] | d[i + 1] << 8);       // Décimos da unidade do canal
+            printf(",%s%d.%d", v < 0 ? "-" : "", abs(v) / 10, abs(v) % 10);
+        }
+        printf("\n");
+    } else if (r->tipo == ENQ_ALARME && r->tam >= 2) {
+        printf("alarme,%u,%lu,%u,%u\n", r->seq, (unsigned long)r->t_us, d[0], d[1]);
+    } else {
+        printf("desconhecido,%u,%lu,%u\n", r->seq, (unsigned long)r->t_us, r->tipo);
+    }
+}
+
+int main(int argc, char **argv) {
+    FILE *f = stdin;
+    if (argc > 1 && !(f = fopen(argv[1], "rb"))) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    uint8_t bruto[MAX_BRUTO];
+    size_t n = 0;
+    bool transbordou = false;
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        if (c != 0) {
+            if (n < sizeof(bruto))
+                bruto[n++] = (uint8_t)c;
+            else
+                transbordou = true;
+            continue;
+        }
+        if (n > 0) {                        // Zeros seguidos são só delimitadores
+            enq_registro_t r;
+            if (!transbordou && enq_decodificar(bruto, n, &r)) {
+                validos++;
+                imprimir(&r);
+            } else {
+                invalidos++;
+            }
+        }
+        n = 0;
+        transbordou = false;
+    }
+
+    fprintf(stderr, "quadros %lu invalidos %lu perdidos %lu\n", validos, invalidos, perdidos);
+    return validos > 0 ? 0 : 1;
+}